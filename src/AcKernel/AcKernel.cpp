@@ -0,0 +1,61 @@
+#include "AcKernel.h"
+
+
+namespace
+{
+    constexpr uint32_t maxCycleDuration_ms = 40;
+}
+
+
+void AcKernel::setCycleRing(CycleRing* cycleRing, bool halfCycles) noexcept
+{
+    if (cycleRing == m_cycleRing && halfCycles == m_halfCycles)
+        return;
+    m_cycleRing = cycleRing;
+    m_halfCycles = halfCycles;
+    m_isCycleOpen = false;
+}
+
+
+void AcKernel::closeCycle(
+    float voltage_V,
+    float current_A,
+    float activePower_W,
+    uint64_t endSampleIndex,
+    uint32_t sampleCount,
+    uint32_t sampleRate_Hz
+) noexcept
+{
+    if (!m_cycleRing)
+        return;
+
+    if (m_isCycleOpen && sampleCount > 0 && sampleRate_Hz > 0)
+    {
+        m_cycleRing->push(CycleMeasurement {
+            .timestamp_us = endSampleIndex * 1000000 / sampleRate_Hz,
+            .duration_us = static_cast<uint32_t>(static_cast<uint64_t>(sampleCount) * 1000000 / sampleRate_Hz),
+            .voltage_V = voltage_V,
+            .current_A = current_A,
+            .activePower_W = activePower_W,
+        });
+    }
+    m_isCycleOpen = true;
+}
+
+
+uint32_t AcKernel::getMaxCycleSampleCount(uint32_t sampleRate_Hz) noexcept
+{
+    return sampleRate_Hz * maxCycleDuration_ms / 1000;
+}
+
+
+void AcKernel::dropCycle() noexcept
+{
+    m_isCycleOpen = false;
+}
+
+
+bool AcKernel::isPublishingCycles() const noexcept
+{
+    return m_cycleRing != nullptr;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "AdcSampler/AdcSampler.h"
+#include "AcPower/AcPower.h"
+#include "CycleMeasurement/CycleMeasurement.h"
+
+struct AcCalibration
+{
+    float voltage;
+    float current;
+    float phase;
+};
+
+
+class AcKernel
+{
+public:
+    // Feeds a block of raw samples. The offset filters carry over from block to block.
+    virtual void process(const AdcSampleBlock& block) noexcept = 0;
+
+    // Returns the values over all samples processed since the previous call and starts a new window.
+    virtual AcPower getResult() noexcept = 0;
+
+    // Additionally publishes one result per mains cycle, or per half cycle, to the given ring
+    void setCycleRing(CycleRing* cycleRing, bool halfCycles = false) noexcept;
+
+    inline virtual ~AcKernel() noexcept = default;
+
+protected:
+    // Called for every filtered voltage sample, true if the sample starts a new (half) cycle.
+    // The hysteresis keeps noise around the zero crossing from splitting cycles.
+    template<typename T>
+    inline bool isCycleBoundary(T filteredV, T hysteresis) noexcept
+    {
+        int8_t polarity = filteredV > hysteresis ? 1 : (filteredV < -hysteresis ? -1 : m_polarity);
+        if (polarity == m_polarity)
+            return false;
+        m_polarity = polarity;
+        return polarity > 0 || m_halfCycles;
+    }
+
+    // The first boundary only opens a cycle, every following one closes and publishes it
+    void closeCycle(
+        float voltage_V,
+        float current_A,
+        float activePower_W,
+        uint64_t endSampleIndex,
+        uint32_t sampleCount,
+        uint32_t sampleRate_Hz
+    ) noexcept;
+
+    // Without a zero crossing, e.g. while no voltage is connected, a cycle would never close and its sums would
+    // overflow. An open cycle longer than twice the period at 50 Hz is dropped instead, the next boundary only
+    // opens a new one. Its samples still count towards the window.
+    static uint32_t getMaxCycleSampleCount(uint32_t sampleRate_Hz) noexcept;
+    void dropCycle() noexcept;
+
+    bool isPublishingCycles() const noexcept;
+
+private:
+    CycleRing* m_cycleRing = nullptr;
+    bool m_halfCycles = false;
+    bool m_isCycleOpen = false;
+    int8_t m_polarity = 0;
+};
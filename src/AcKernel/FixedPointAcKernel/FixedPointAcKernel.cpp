@@ -0,0 +1,133 @@
+#include "FixedPointAcKernel.h"
+#include <math.h>
+
+
+namespace
+{
+    // Same low pass as the floating point kernel: offset += (sample - offset) / 1024
+    constexpr uint8_t offsetFilterShift = 10;
+    constexpr uint8_t phaseFractionBits = 14;
+    constexpr float filteredScale = 256.0f;
+    constexpr int32_t cycleHysteresis_Q8 = 32 << 8;
+}
+
+
+FixedPointAcKernel::FixedPointAcKernel(const AcCalibration& calibration) noexcept :
+    m_calibration(calibration),
+    m_phase_Q14(lroundf(calibration.phase * (1 << phaseFractionBits))),
+    m_offsetV_Q16((adcResolution_counts / 2) << 16),
+    m_offsetI_Q16((adcResolution_counts / 2) << 16)
+{}
+
+
+void FixedPointAcKernel::process(const AdcSampleBlock& block) noexcept
+{
+    int32_t offsetV_Q16 = m_offsetV_Q16;
+    int32_t offsetI_Q16 = m_offsetI_Q16;
+    int32_t filteredV_Q8 = m_filteredV_Q8;
+    Sums sums = m_cycleSums;
+    int32_t maxCycleSampleCount = getMaxCycleSampleCount(block.sampleRate_Hz);
+
+    for (size_t i = 0; i < block.size; i++)
+    {
+        int32_t lastFilteredV_Q8 = filteredV_Q8;
+
+        int32_t sampleV_Q16 = static_cast<int32_t>(block.voltage[i]) << 16;
+        offsetV_Q16 += (sampleV_Q16 - offsetV_Q16) >> offsetFilterShift;
+        filteredV_Q8 = (sampleV_Q16 - offsetV_Q16) >> 8;
+
+        int32_t sampleI_Q16 = static_cast<int32_t>(block.current[i]) << 16;
+        offsetI_Q16 += (sampleI_Q16 - offsetI_Q16) >> offsetFilterShift;
+        int32_t filteredI_Q8 = (sampleI_Q16 - offsetI_Q16) >> 8;
+
+        if (isCycleBoundary(filteredV_Q8, cycleHysteresis_Q8))
+        {
+            finishCycle(sums, m_sampleIndex + i, block.sampleRate_Hz);
+            sums = {0, 0, 0, 0};
+        }
+        else if (sums.sampleCount >= maxCycleSampleCount)
+        {
+            addToWindow(sums);
+            dropCycle();
+            sums = {0, 0, 0, 0};
+        }
+
+        sums.voltage_Q16 += static_cast<int64_t>(filteredV_Q8) * filteredV_Q8;
+        sums.current_Q16 += static_cast<int64_t>(filteredI_Q8) * filteredI_Q8;
+
+        int32_t phaseShiftedV_Q8 = lastFilteredV_Q8 + static_cast<int32_t>(
+            (static_cast<int64_t>(m_phase_Q14) * (filteredV_Q8 - lastFilteredV_Q8)) >> phaseFractionBits
+        );
+        sums.power_Q16 += static_cast<int64_t>(phaseShiftedV_Q8) * filteredI_Q8;
+        sums.sampleCount++;
+    }
+
+    m_offsetV_Q16 = offsetV_Q16;
+    m_offsetI_Q16 = offsetI_Q16;
+    m_filteredV_Q8 = filteredV_Q8;
+    m_cycleSums = sums;
+    m_sampleIndex += block.size;
+}
+
+
+AcPower FixedPointAcKernel::getResult() noexcept
+{
+    Sums sums = {
+        m_windowSums.voltage_Q16 + m_cycleSums.voltage_Q16,
+        m_windowSums.current_Q16 + m_cycleSums.current_Q16,
+        m_windowSums.power_Q16 + m_cycleSums.power_Q16,
+        m_windowSums.sampleCount + m_cycleSums.sampleCount,
+    };
+
+    // The open cycle is already part of this window, so it is carried over as a negative
+    // offset and cancels out once the whole cycle gets added to the next window.
+    m_windowSums = {
+        -m_cycleSums.voltage_Q16,
+        -m_cycleSums.current_Q16,
+        -m_cycleSums.power_Q16,
+        -m_cycleSums.sampleCount,
+    };
+    return calculate(sums);
+}
+
+
+void FixedPointAcKernel::finishCycle(const Sums& cycleSums, uint64_t endSampleIndex, uint32_t sampleRate_Hz) noexcept
+{
+    addToWindow(cycleSums);
+
+    if (!isPublishingCycles())
+        return;
+
+    AcPower cycle = calculate(cycleSums);
+    closeCycle(
+        cycle.getVoltage_V(),
+        cycle.getCurrent_A(),
+        cycle.getSignedActivePower_W(),
+        endSampleIndex,
+        cycleSums.sampleCount,
+        sampleRate_Hz
+    );
+}
+
+
+void FixedPointAcKernel::addToWindow(const Sums& cycleSums) noexcept
+{
+    m_windowSums.voltage_Q16 += cycleSums.voltage_Q16;
+    m_windowSums.current_Q16 += cycleSums.current_Q16;
+    m_windowSums.power_Q16 += cycleSums.power_Q16;
+    m_windowSums.sampleCount += cycleSums.sampleCount;
+}
+
+
+AcPower FixedPointAcKernel::calculate(const Sums& sums) const noexcept
+{
+    if (sums.sampleCount <= 0)
+        return AcPower(0.0f, 0.0f, 0.0f);
+
+    float voltageRatio = m_calibration.voltage * (adcReferenceVoltage_V / adcResolution_counts) / filteredScale;
+    float currentRatio = m_calibration.current * (adcReferenceVoltage_V / adcResolution_counts) / filteredScale;
+    float voltage_V = voltageRatio * sqrtf(static_cast<float>(sums.voltage_Q16) / sums.sampleCount);
+    float current_A = currentRatio * sqrtf(static_cast<float>(sums.current_Q16) / sums.sampleCount);
+    float activePower_W = voltageRatio * currentRatio * (static_cast<float>(sums.power_Q16) / sums.sampleCount);
+    return AcPower(voltage_V, current_A, activePower_W);
+}
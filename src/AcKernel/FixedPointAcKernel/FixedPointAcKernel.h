@@ -0,0 +1,37 @@
+#pragma once
+
+#include "AcKernel/AcKernel.h"
+
+// Integer version of FloatingPointAcKernel. The ESP32 has no double precision FPU, so the
+// per-sample math runs on scaled int32 values with int64 accumulators. Floating point is
+// only used once per window or cycle to scale the sums.
+class FixedPointAcKernel : public AcKernel
+{
+public:
+    FixedPointAcKernel(const AcCalibration& calibration) noexcept;
+
+    void process(const AdcSampleBlock& block) noexcept override;
+    AcPower getResult() noexcept override;
+
+private:
+    struct Sums
+    {
+        int64_t voltage_Q16;
+        int64_t current_Q16;
+        int64_t power_Q16;
+        int32_t sampleCount;
+    };
+
+    void finishCycle(const Sums& cycleSums, uint64_t endSampleIndex, uint32_t sampleRate_Hz) noexcept;
+    void addToWindow(const Sums& cycleSums) noexcept;
+    AcPower calculate(const Sums& sums) const noexcept;
+
+    AcCalibration m_calibration;
+    int32_t m_phase_Q14;
+    int32_t m_offsetV_Q16;
+    int32_t m_offsetI_Q16;
+    int32_t m_filteredV_Q8 = 0;
+    uint64_t m_sampleIndex = 0;
+    Sums m_windowSums = {0, 0, 0, 0};
+    Sums m_cycleSums = {0, 0, 0, 0};
+};
@@ -0,0 +1,114 @@
+#include "FloatingPointAcKernel.h"
+#include <math.h>
+
+
+namespace
+{
+    constexpr double offsetFilterDivisor = 1024.0;
+    constexpr double cycleHysteresis = 32.0;
+}
+
+
+FloatingPointAcKernel::FloatingPointAcKernel(const AcCalibration& calibration) noexcept :
+    m_calibration(calibration),
+    m_offsetV(adcResolution_counts / 2),
+    m_offsetI(adcResolution_counts / 2)
+{}
+
+
+void FloatingPointAcKernel::process(const AdcSampleBlock& block) noexcept
+{
+    int32_t maxCycleSampleCount = getMaxCycleSampleCount(block.sampleRate_Hz);
+    for (size_t i = 0; i < block.size; i++)
+    {
+        double lastFilteredV = m_filteredV;
+
+        m_offsetV = m_offsetV + ((block.voltage[i] - m_offsetV) / offsetFilterDivisor);
+        m_filteredV = block.voltage[i] - m_offsetV;
+        m_offsetI = m_offsetI + ((block.current[i] - m_offsetI) / offsetFilterDivisor);
+        double filteredI = block.current[i] - m_offsetI;
+
+        if (isCycleBoundary(m_filteredV, cycleHysteresis))
+        {
+            finishCycle(m_cycleSums, m_sampleIndex + i, block.sampleRate_Hz);
+            m_cycleSums = {0.0, 0.0, 0.0, 0};
+        }
+        else if (m_cycleSums.sampleCount >= maxCycleSampleCount)
+        {
+            addToWindow(m_cycleSums);
+            dropCycle();
+            m_cycleSums = {0.0, 0.0, 0.0, 0};
+        }
+
+        m_cycleSums.voltage += m_filteredV * m_filteredV;
+        m_cycleSums.current += filteredI * filteredI;
+
+        double phaseShiftedV = lastFilteredV + m_calibration.phase * (m_filteredV - lastFilteredV);
+        m_cycleSums.power += phaseShiftedV * filteredI;
+        m_cycleSums.sampleCount++;
+    }
+    m_sampleIndex += block.size;
+}
+
+
+AcPower FloatingPointAcKernel::getResult() noexcept
+{
+    Sums sums = {
+        m_windowSums.voltage + m_cycleSums.voltage,
+        m_windowSums.current + m_cycleSums.current,
+        m_windowSums.power + m_cycleSums.power,
+        m_windowSums.sampleCount + m_cycleSums.sampleCount,
+    };
+
+    // The open cycle is already part of this window, so it is carried over as a negative
+    // offset and cancels out once the whole cycle gets added to the next window.
+    m_windowSums = {
+        -m_cycleSums.voltage,
+        -m_cycleSums.current,
+        -m_cycleSums.power,
+        -m_cycleSums.sampleCount,
+    };
+    return calculate(sums);
+}
+
+
+void FloatingPointAcKernel::finishCycle(const Sums& cycleSums, uint64_t endSampleIndex, uint32_t sampleRate_Hz) noexcept
+{
+    addToWindow(cycleSums);
+
+    if (!isPublishingCycles())
+        return;
+
+    AcPower cycle = calculate(cycleSums);
+    closeCycle(
+        cycle.getVoltage_V(),
+        cycle.getCurrent_A(),
+        cycle.getSignedActivePower_W(),
+        endSampleIndex,
+        cycleSums.sampleCount,
+        sampleRate_Hz
+    );
+}
+
+
+void FloatingPointAcKernel::addToWindow(const Sums& cycleSums) noexcept
+{
+    m_windowSums.voltage += cycleSums.voltage;
+    m_windowSums.current += cycleSums.current;
+    m_windowSums.power += cycleSums.power;
+    m_windowSums.sampleCount += cycleSums.sampleCount;
+}
+
+
+AcPower FloatingPointAcKernel::calculate(const Sums& sums) const noexcept
+{
+    if (sums.sampleCount <= 0)
+        return AcPower(0.0f, 0.0f, 0.0f);
+
+    double voltageRatio = m_calibration.voltage * (adcReferenceVoltage_V / adcResolution_counts);
+    double currentRatio = m_calibration.current * (adcReferenceVoltage_V / adcResolution_counts);
+    double voltage_V = voltageRatio * sqrt(sums.voltage / sums.sampleCount);
+    double current_A = currentRatio * sqrt(sums.current / sums.sampleCount);
+    double activePower_W = voltageRatio * currentRatio * sums.power / sums.sampleCount;
+    return AcPower(voltage_V, current_A, activePower_W);
+}
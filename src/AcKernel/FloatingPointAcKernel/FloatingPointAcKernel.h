@@ -0,0 +1,34 @@
+#pragma once
+
+#include "AcKernel/AcKernel.h"
+
+// Same per-sample math as EmonLib's calcVI(), applied to sample blocks instead of analogRead() calls
+class FloatingPointAcKernel : public AcKernel
+{
+public:
+    FloatingPointAcKernel(const AcCalibration& calibration) noexcept;
+
+    void process(const AdcSampleBlock& block) noexcept override;
+    AcPower getResult() noexcept override;
+
+private:
+    struct Sums
+    {
+        double voltage;
+        double current;
+        double power;
+        int32_t sampleCount;
+    };
+
+    void finishCycle(const Sums& cycleSums, uint64_t endSampleIndex, uint32_t sampleRate_Hz) noexcept;
+    void addToWindow(const Sums& cycleSums) noexcept;
+    AcPower calculate(const Sums& sums) const noexcept;
+
+    AcCalibration m_calibration;
+    double m_offsetV;
+    double m_offsetI;
+    double m_filteredV = 0.0;
+    uint64_t m_sampleIndex = 0;
+    Sums m_windowSums = {0.0, 0.0, 0.0, 0};
+    Sums m_cycleSums = {0.0, 0.0, 0.0, 0};
+};
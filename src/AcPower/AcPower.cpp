@@ -33,6 +33,15 @@ float AcPower::getActivePower_W() const noexcept
 }
 
 
+// Unlike getActivePower_W(), this keeps the sign, so exported power is negative
+float AcPower::getSignedActivePower_W() const noexcept
+{
+    if (!isfinite(m_activePower_W))
+        return 0.0f;
+    return m_activePower_W;
+}
+
+
 float AcPower::getReactivePower_var() const noexcept
 {
     float apparentPower_VA = getApparentPower_VA();
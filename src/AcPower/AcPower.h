@@ -7,6 +7,7 @@ public:
     float getVoltage_V() const noexcept;
     float getCurrent_A() const noexcept;
     float getActivePower_W() const noexcept;
+    float getSignedActivePower_W() const noexcept;
     float getReactivePower_var() const noexcept;
     float getApparentPower_VA() const noexcept;
     float getPowerFactor() const noexcept;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+constexpr uint16_t adcResolution_counts = 4096;
+constexpr float adcReferenceVoltage_V = 3.3f;
+
+struct AdcSampleBlock
+{
+    // 6.4 ms at 5 kHz. Cycle results are only published once their block is processed, so this bounds their latency.
+    static constexpr size_t capacity = 32;
+
+    uint16_t voltage[capacity];
+    uint16_t current[capacity];
+    size_t size = 0;
+    uint32_t sampleRate_Hz = 0;
+    uint32_t sequenceNumber = 0;
+};
+
+
+class AdcSampler
+{
+public:
+    // Blocks until the next block of simultaneous voltage and current samples is available.
+    // The sampler keeps converting while the caller processes a block, so consecutive
+    // blocks are gapless as long as the caller keeps up.
+    virtual void read(AdcSampleBlock& block) = 0;
+    inline virtual ~AdcSampler() noexcept = default;
+};
@@ -0,0 +1,132 @@
+#ifdef ESP32
+
+#include "I2sAdcSampler.h"
+#include "SourceLocation/SourceLocation.h"
+#include "Logger/Logger.h"
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <soc/syscon_struct.h>
+#include <sstream>
+#include <stdexcept>
+
+
+namespace
+{
+    // Only I2S0 can be connected to the built-in ADC
+    constexpr i2s_port_t i2sPort = I2S_NUM_0;
+    constexpr uint8_t channelCount = 2;
+    // Buffers about 200 ms at 5 kHz, in case the measuring task is held up
+    constexpr int dmaBufferCount = 32;
+
+
+    adc1_channel_t getAdc1Channel(uint8_t pin)
+    {
+        int8_t channel = digitalPinToAnalogChannel(pin);
+        if (channel < 0 || channel >= ADC1_CHANNEL_MAX)
+        {
+            std::stringstream errorMessage;
+            errorMessage << "Pin " << static_cast<int>(pin) << " is not an ADC1 pin, which is required for I2S sampling";
+            throw std::runtime_error(SOURCE_LOCATION + errorMessage.str());
+        }
+        return static_cast<adc1_channel_t>(channel);
+    }
+
+
+    uint32_t getPatternTableEntry(adc1_channel_t channel)
+    {
+        // Bits 7..4: channel, bits 3..2: bit width, bits 1..0: attenuation
+        return (channel << 4) | (ADC_WIDTH_BIT_12 << 2) | ADC_ATTEN_DB_11;
+    }
+}
+
+
+I2sAdcSampler::I2sAdcSampler(uint8_t voltagePin, uint8_t currentPin, uint32_t sampleRate_Hz) :
+    m_voltageChannel(getAdc1Channel(voltagePin)),
+    m_currentChannel(getAdc1Channel(currentPin)),
+    m_sampleRate_Hz(sampleRate_Hz)
+{
+    // Samples are told apart by their channel only, so a shared pin would never yield a current sample
+    if (m_voltageChannel == m_currentChannel)
+        throw std::runtime_error(SOURCE_LOCATION + "Voltage and current must be sampled on different pins");
+
+    i2s_config_t i2sConfig = {};
+    i2sConfig.mode = static_cast<i2s_mode_t>(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    i2sConfig.sample_rate = sampleRate_Hz * channelCount;
+    i2sConfig.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2sConfig.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    i2sConfig.communication_format = I2S_COMM_FORMAT_STAND_I2S;
+    i2sConfig.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    // The DMA keeps filling the next buffers while the measuring task processes the current block
+    i2sConfig.dma_buf_count = dmaBufferCount;
+    i2sConfig.dma_buf_len = AdcSampleBlock::capacity * channelCount;
+    i2sConfig.use_apll = false;
+
+    if (i2s_driver_install(i2sPort, &i2sConfig, 0, nullptr) != ESP_OK)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to install I2S driver");
+
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten(m_voltageChannel, ADC_ATTEN_DB_11);
+    adc1_config_channel_atten(m_currentChannel, ADC_ATTEN_DB_11);
+    if (i2s_set_adc_mode(ADC_UNIT_1, m_voltageChannel) != ESP_OK)
+    {
+        i2s_driver_uninstall(i2sPort);
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to set I2S ADC mode");
+    }
+
+    try
+    {
+        enable();
+    }
+    catch (...)
+    {
+        i2s_driver_uninstall(i2sPort);
+        throw;
+    }
+}
+
+
+I2sAdcSampler::~I2sAdcSampler() noexcept
+{
+    i2s_adc_disable(i2sPort);
+    i2s_driver_uninstall(i2sPort);
+}
+
+
+void I2sAdcSampler::enable()
+{
+    if (i2s_adc_enable(i2sPort) != ESP_OK)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to enable I2S ADC");
+
+    // i2s_set_adc_mode() only scans a single channel, so alternate between both channels instead. Enabling
+    // writes the single channel pattern of i2s_set_adc_mode() again, so this has to follow every enable.
+    SYSCON.saradc_ctrl.sar1_patt_len = channelCount - 1;
+    SYSCON.saradc_sar1_patt_tab[0] =
+        (getPatternTableEntry(m_voltageChannel) << 24) | (getPatternTableEntry(m_currentChannel) << 16);
+}
+
+
+void I2sAdcSampler::read(AdcSampleBlock& block)
+{
+    size_t bytesRead = 0;
+    if (i2s_read(i2sPort, m_rawSamples, sizeof(m_rawSamples), &bytesRead, portMAX_DELAY) != ESP_OK)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to read from I2S ADC");
+
+    // Every raw sample carries its channel in the upper 4 bits
+    size_t voltageCount = 0;
+    size_t currentCount = 0;
+    for (size_t i = 0; i < bytesRead / sizeof(uint16_t); i++)
+    {
+        uint16_t channel = m_rawSamples[i] >> 12;
+        uint16_t value = m_rawSamples[i] & 0x0FFF;
+        if (channel == m_voltageChannel && voltageCount < AdcSampleBlock::capacity)
+            block.voltage[voltageCount++] = value;
+        else if (channel == m_currentChannel && currentCount < AdcSampleBlock::capacity)
+            block.current[currentCount++] = value;
+    }
+
+    block.size = voltageCount < currentCount ? voltageCount : currentCount;
+    block.sampleRate_Hz = m_sampleRate_Hz;
+    block.sequenceNumber = m_sequenceNumber++;
+}
+
+#endif
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "AdcSampler/AdcSampler.h"
+#include <driver/adc.h>
+
+class I2sAdcSampler : public AdcSampler
+{
+public:
+    I2sAdcSampler(uint8_t voltagePin, uint8_t currentPin, uint32_t sampleRate_Hz);
+    I2sAdcSampler(const I2sAdcSampler&) = delete;
+    I2sAdcSampler& operator=(const I2sAdcSampler&) = delete;
+    ~I2sAdcSampler() noexcept;
+
+    void read(AdcSampleBlock& block) override;
+
+private:
+    // Enables the ADC and programs the pattern table for both channels
+    void enable();
+
+    adc1_channel_t m_voltageChannel;
+    adc1_channel_t m_currentChannel;
+    uint32_t m_sampleRate_Hz;
+    uint32_t m_sequenceNumber = 0;
+    uint16_t m_rawSamples[AdcSampleBlock::capacity * 2];
+};
@@ -0,0 +1,59 @@
+#include "SyntheticAdcSampler.h"
+#include <math.h>
+#include <utility>
+
+
+SyntheticAdcSampler::SyntheticAdcSampler(
+    Signal voltageSignal,
+    Signal currentSignal,
+    uint32_t sampleRate_Hz,
+    float frequency_Hz
+) noexcept :
+    m_voltageSignal(std::move(voltageSignal)),
+    m_currentSignal(std::move(currentSignal)),
+    m_sampleRate_Hz(sampleRate_Hz),
+    m_frequency_Hz(frequency_Hz)
+{}
+
+
+void SyntheticAdcSampler::read(AdcSampleBlock& block) noexcept
+{
+    for (size_t i = 0; i < AdcSampleBlock::capacity; i++)
+    {
+        double time_s = static_cast<double>(m_sampleIndex++) / m_sampleRate_Hz;
+        block.voltage[i] = sample(m_voltageSignal, time_s);
+        block.current[i] = sample(m_currentSignal, time_s);
+    }
+    block.size = AdcSampleBlock::capacity;
+    block.sampleRate_Hz = m_sampleRate_Hz;
+    block.sequenceNumber = m_sequenceNumber++;
+}
+
+
+void SyntheticAdcSampler::setCurrentSignal(Signal currentSignal) noexcept
+{
+    m_currentSignal = std::move(currentSignal);
+}
+
+
+uint16_t SyntheticAdcSampler::sample(const Signal& signal, double time_s) noexcept
+{
+    double value = signal.offset_counts;
+    for (const auto& harmonic : signal.harmonics)
+        value += harmonic.amplitude_counts * sin(2.0 * M_PI * m_frequency_Hz * harmonic.order * time_s + harmonic.phase_rad);
+
+    if (signal.noise_counts > 0.0f)
+    {
+        // xorshift32, so the generated blocks are reproducible between runs
+        m_noiseState ^= m_noiseState << 13;
+        m_noiseState ^= m_noiseState >> 17;
+        m_noiseState ^= m_noiseState << 5;
+        value += signal.noise_counts * (static_cast<double>(m_noiseState) / UINT32_MAX * 2.0 - 1.0);
+    }
+
+    if (value < 0.0)
+        return 0;
+    if (value > adcResolution_counts - 1)
+        return adcResolution_counts - 1;
+    return static_cast<uint16_t>(lround(value));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "AdcSampler/AdcSampler.h"
+#include <vector>
+
+class SyntheticAdcSampler : public AdcSampler
+{
+public:
+    struct Harmonic
+    {
+        uint8_t order;
+        float amplitude_counts;
+        float phase_rad;
+    };
+
+    struct Signal
+    {
+        float offset_counts;
+        std::vector<Harmonic> harmonics;
+        float noise_counts;
+    };
+
+    SyntheticAdcSampler(
+        Signal voltageSignal,
+        Signal currentSignal,
+        uint32_t sampleRate_Hz,
+        float frequency_Hz = 50.0f
+    ) noexcept;
+
+    void read(AdcSampleBlock& block) noexcept override;
+    void setCurrentSignal(Signal currentSignal) noexcept;
+
+private:
+    uint16_t sample(const Signal& signal, double time_s) noexcept;
+
+    Signal m_voltageSignal;
+    Signal m_currentSignal;
+    uint32_t m_sampleRate_Hz;
+    float m_frequency_Hz;
+    uint64_t m_sampleIndex = 0;
+    uint32_t m_sequenceNumber = 0;
+    uint32_t m_noiseState = 1;
+};
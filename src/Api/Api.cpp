@@ -6,6 +6,8 @@
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "SourceLocation/SourceLocation.h"
 #include "Filesystem/Directory/LittleFsDirectory/LittleFsDirectory.h"
+#include "Filesystem/File/LittleFsFile/LittleFsFile.h"
+#include "JsonResource/CoalescingJsonResource/CoalescingJsonResource.h"
 #include "WifiScan/WifiScan.h"
 #include <LittleFS.h>
 #include <vector>
@@ -13,12 +15,24 @@
 
 namespace
 {
+    // Points per response of the history, about 30 kB of JSON
+    constexpr size_t historyPageSize = 1440;
+
+
     RestApi::JsonResponse getJsonResource(JsonResource* jsonResource)
     {
         return RestApi::JsonResponse(jsonResource->deserialize());
     }
 
 
+    RestApi::GenerationGetter getGeneration(const JsonResource* jsonResource)
+    {
+        return [jsonResource]{
+            return jsonResource->getGeneration();
+        };
+    }
+
+
     RestApi::JsonResponse putJsonResource(JsonResource* jsonResource, const json& requestJson)
     {
         jsonResource->serialize(requestJson);
@@ -26,60 +40,100 @@ namespace
     }
 
 
-    size_t getJsonSizeRecursive(const json& data)
+    // Replacing the unit destroys the running one, so the measuring task does it between two windows
+    void reconfigureMeasuring(
+        const json& currentConfigJson,
+        const json& configJson,
+        MeasuringUnit** measuringUnit,
+        Rtos::SafePoint* measuringSafePoint
+    )
     {
-        if (data.is_object())
-        {
-            size_t size = 0;
-            for (const auto& child : data.items())
-                size += getJsonSizeRecursive(child.value());
-            return size;
-        }
-        else if (data.is_array())
-        {
-            size_t size = data.size();
-            for (const auto& element : data)
-                size += getJsonSizeRecursive(element);
-            return size;
-        }
-        else
-        {
-            return data.size();
-        }
+        measuringSafePoint->run([&currentConfigJson, &configJson, measuringUnit]{
+            try
+            {
+                *measuringUnit = Config::configureMeasuring(configJson);
+            }
+            catch (...)
+            {
+                // The running unit may be gone already, so it is rebuilt from the config it was built from
+                std::exception_ptr exception = std::current_exception();
+                try
+                {
+                    *measuringUnit = Config::configureMeasuring(currentConfigJson);
+                }
+                catch (...)
+                {
+                    *measuringUnit = nullptr;
+                    Logger[LogLevel::Error] << "Measuring stopped, failed to restore the measuring unit" << std::endl;
+                }
+                std::rethrow_exception(exception);
+            }
+        });
     }
 
 
-    void patchJson(
-        json& targetJson,
-        const json& patchJson,
-        const std::vector<json::json_pointer>& readonlyItems = {"/version"_json_pointer},
-        bool allowAdding = false
-    )
+    // The snapshot stays null until the tracker task has loaded the trackers
+    bool areTrackersLoaded(const Rtos::PublishedValue<json>* trackersData)
     {
-        for (const auto& readonlyItem : readonlyItems)
-        {
-            if (patchJson.contains(readonlyItem))
-                throw std::runtime_error(SOURCE_LOCATION + "Property at \"" + readonlyItem.to_string() + "\" is readonly");
-        }
+        return !trackersData->get()->is_null();
+    }
 
-        size_t sizeBefore = getJsonSizeRecursive(targetJson);
 
-        targetJson.merge_patch(patchJson);
+    RestApi::JsonResponse getTrackersLoadingResponse()
+    {
+        return RestApi::JsonResponse(json{{"loading", true}}, 503, {{"Retry-After", "1"}});
+    }
+
 
-        if(!allowAdding && getJsonSizeRecursive(targetJson) > sizeBefore)
-            throw std::runtime_error(SOURCE_LOCATION + "Adding properties using PATCH is not allowed");
+    void reconfigureTrackers(
+        const json& currentConfigJson,
+        const json& configJson,
+        const Clock* clock,
+        Rtos::ValueMutex<TrackerMap>* trackersValueMutex,
+        Rtos::PublishedValue<json>* trackersData
+    )
+    {
+        TrackerReconciliation::Plan plan = TrackerReconciliation::plan(currentConfigJson.at("trackers"), configJson.at("trackers"));
+        // Built before the lock is taken, a failure leaves the running trackers and their files untouched
+        TrackerMap preparedTrackers = Config::prepareTrackers(plan, configJson, clock);
+        TrackerMap removedTrackers;
+        {
+            Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex->get();
+            removedTrackers = Config::reconfigureTrackers(&*trackers, plan, std::move(preparedTrackers), configJson);
+            trackersData->publish(getTrackersData(*trackers));
+        }
+        for (auto& removedTracker : removedTrackers)
+        {
+            Logger[LogLevel::Info] << "Removing tracker \"" << removedTracker.first << "\"..." << std::endl;
+            try
+            {
+                removedTracker.second.erase();
+            }
+            catch (...)
+            {
+                // The new config is in effect already, the leftover files are only wasted space
+                Logger[LogLevel::Warning] << "Failed to erase tracker \"" << removedTracker.first << "\": " << ExceptionTrace::what() << std::endl;
+                ExceptionTrace::clear();
+            }
+        }
     }
 }
 
 
-void Api::createSystemEndpoints(RestApi* restApi, const Version& firmwareVersion, const Version& apiVersion) noexcept
+void Api::createSystemEndpoints(
+    RestApi* restApi,
+    const Version& firmwareVersion,
+    const Version& apiVersion,
+    const BootTimeline* bootTimeline
+) noexcept
 {
-    restApi->handle("/info", HTTP_GET, [firmwareVersion, apiVersion](RestApi::JsonRequest){
+    restApi->handle("/info", HTTP_GET, [firmwareVersion, apiVersion, bootTimeline](RestApi::JsonRequest){
         std::stringstream chipdId;
         chipdId << std::hex << ESP.getEfuseMac();
         return json {
             {"chipId", chipdId.str()},
             {"uptime_s", millis() / 1000.0},
+            {"boot", bootTimeline->toJson()},
             {"versions", {
                 {"firmware", std::string(firmwareVersion)},
                 {"api", std::string(firmwareVersion)},
@@ -88,6 +142,8 @@ void Api::createSystemEndpoints(RestApi* restApi, const Version& firmwareVersion
                 {"filesystem", {
                     {"totalBytes", LittleFS.totalBytes()},
                     {"usedBytes", LittleFS.usedBytes()},
+                    {"writeCount", Filesystem::LittleFsFile::getWriteCount()},
+                    {"coalescing", CoalescingJsonResource::getTotalStatistics().toJson()},
                 }},
                 {"heap", {
                     {"totalBytes", ESP.getHeapSize()},
@@ -104,8 +160,9 @@ void Api::createSystemEndpoints(RestApi* restApi, const Version& firmwareVersion
         });
     });
 
-    restApi->handle("/files(.*)", HTTP_GET, [](const RestApi::JsonRequest& request){
-        return Filesystem::LittleFsDirectory(request.serverRequest.pathArg(1).c_str()).toJson().at("children");
+    restApi->handle("/files/{path*}", HTTP_GET, [](const RestApi::JsonRequest& request){
+        json directoryJson = Filesystem::LittleFsDirectory("/" + request.params.get("path")).toJson();
+        return std::move(directoryJson.at("children"));
     });
 }
 
@@ -114,11 +171,13 @@ void Api::createLoggerEndpoints(RestApi* restApi, JsonResource* configResource,
 {
     restApi->handle("/logger/config", HTTP_GET, [configResource](RestApi::JsonRequest){
         return getJsonResource(configResource);
-    });
+    }, getGeneration(configResource));
 
     restApi->handle("/logger/config", HTTP_PATCH, [configResource, server](const RestApi::JsonRequest& request){
         json configJson = configResource->deserialize();
-        patchJson(configJson, request.data);
+        // Nothing to reconfigure, when the patch does not change anything
+        if (!Config::getLoggerSchema().patch(&configJson, request.data))
+            return configJson;
         Config::configureLogger(configJson, server);
         configResource->serialize(configJson);
         return configJson;
@@ -141,25 +200,49 @@ void Api::createMeasuringEndpoints(
     RestApi* restApi,
     JsonResource* configResource,
     MeasuringUnit** measuringUnit,
-    Rtos::ValueMutex<MeasurementList>* measurementsValueMutex
+    Rtos::SafePoint* measuringSafePoint,
+    const Rtos::SeqLock<MeasurementFrame>* measurements,
+    const CycleRing* cycleRing,
+    const EnergyRegister* energyRegister
 ) noexcept
 {
-    restApi->handle("/measurements", HTTP_GET, [measurementsValueMutex](RestApi::JsonRequest){
-        json responseJson = json::array_t();
-        Rtos::ValueMutex<MeasurementList>::Lock measurements = measurementsValueMutex->get();
-        for (const auto& measurement : *measurements)
-            responseJson.push_back(measurement.toJson());
-        return responseJson;
+    restApi->handle("/measurements", HTTP_GET, [measurements](RestApi::JsonRequest){
+        return measurements->load().toJson();
+    }, [measurements]{
+        return measurements->getGeneration();
     });
 
-    restApi->handle("/measuring/config", HTTP_GET, [configResource](RestApi::JsonRequest){
-        return getJsonResource(configResource);
+    restApi->handle("/measurements/cycles", HTTP_GET, [cycleRing](const RestApi::JsonRequest& request){
+        CycleRing::Cursor cursor = cycleRing->getCursor(0);
+        if (request.serverRequest.hasParam("since"))
+            cursor = cycleRing->getCursor(request.serverRequest.getParam("since")->value().toInt());
+
+        json cyclesJson = json::array_t();
+        CycleMeasurement cycle;
+        while (cycleRing->pop(cursor, cycle))
+            cyclesJson.push_back(cycle.toJson());
+
+        return json {
+            {"next", cursor.getPosition()},
+            {"dropped", cursor.getDroppedCount()},
+            {"cycles", cyclesJson},
+        };
     });
 
-    restApi->handle("/measuring/config", HTTP_PATCH, [configResource, measuringUnit](const RestApi::JsonRequest& request){
-        json configJson = configResource->deserialize();
-        patchJson(configJson, request.data);
-        *measuringUnit = Config::configureMeasuring(configJson);
+    restApi->handle("/measurements/energy", HTTP_GET, [energyRegister](RestApi::JsonRequest){
+        return energyRegister->toJson();
+    });
+
+    restApi->handle("/measuring/config", HTTP_GET, [configResource](RestApi::JsonRequest){
+        return getJsonResource(configResource);
+    }, getGeneration(configResource));
+
+    restApi->handle("/measuring/config", HTTP_PATCH, [configResource, measuringUnit, measuringSafePoint](const RestApi::JsonRequest& request){
+        const json currentConfigJson = configResource->deserialize();
+        json configJson = currentConfigJson;
+        if (!Config::getMeasuringSchema().patch(&configJson, request.data))
+            return configJson;
+        reconfigureMeasuring(currentConfigJson, configJson, measuringUnit, measuringSafePoint);
         configResource->serialize(configJson);
         return configJson;
     });
@@ -168,9 +251,9 @@ void Api::createMeasuringEndpoints(
         return Config::getMeasuringDefault();
     });
 
-    restApi->handle("/measuring/config/restore-default", HTTP_POST, [configResource, measuringUnit](RestApi::JsonRequest){
+    restApi->handle("/measuring/config/restore-default", HTTP_POST, [configResource, measuringUnit, measuringSafePoint](RestApi::JsonRequest){
         json defaultConfigJson = Config::getMeasuringDefault();
-        *measuringUnit = Config::configureMeasuring(defaultConfigJson);
+        reconfigureMeasuring(configResource->deserialize(), defaultConfigJson, measuringUnit, measuringSafePoint);
         configResource->serialize(defaultConfigJson);
         return defaultConfigJson;
     });
@@ -198,11 +281,12 @@ void Api::createSwitchEndpoints(RestApi* restApi, JsonResource* configResource,
 
     restApi->handle("/switch/config", HTTP_GET, [configResource](RestApi::JsonRequest){
         return getJsonResource(configResource);
-    });
+    }, getGeneration(configResource));
 
     restApi->handle("/switch/config", HTTP_PATCH, [configResource, switchUnit](const RestApi::JsonRequest& request){
         json configJson = configResource->deserialize();
-        patchJson(configJson, request.data);
+        if (!Config::getSwitchSchema().patch(&configJson, request.data))
+            return configJson;
         *switchUnit = Config::configureSwitch(configJson);
         configResource->serialize(configJson);
         return configJson;
@@ -225,11 +309,12 @@ void Api::createClockEndpoints(RestApi* restApi, JsonResource* configResource, C
 {
     restApi->handle("/clock/config", HTTP_GET, [configResource](RestApi::JsonRequest){
         return getJsonResource(configResource);
-    });
+    }, getGeneration(configResource));
 
     restApi->handle("/clock/config", HTTP_PATCH, [configResource, clock](const RestApi::JsonRequest& request){
         json configJson = configResource->deserialize();
-        patchJson(configJson, request.data);
+        if (!Config::getClockSchema().patch(&configJson, request.data))
+            return configJson;
         *clock = Config::configureClock(configJson);
         configResource->serialize(configJson);
         return configJson;
@@ -252,22 +337,28 @@ void Api::createTrackerEndpoints(
     RestApi* restApi,
     JsonResource* configResource,
     Rtos::ValueMutex<TrackerMap>* trackersValueMutex,
+    Rtos::PublishedValue<json>* trackersData,
     const Clock* clock
 ) noexcept
 {
-    restApi->handle("/trackers", HTTP_GET, [trackersValueMutex](RestApi::JsonRequest){
-        Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex->get();
-        json responseJson = json::object_t();
-        for(const auto& tracker : *trackers)
-            responseJson[tracker.first] = tracker.second.getData();
-        return RestApi::JsonResponse(responseJson);
-    });
-
-    restApi->handle("/trackers", HTTP_PUT, [trackersValueMutex](const RestApi::JsonRequest& request){
+    // Served from the published snapshot, so it never waits for the tracker task writing to flash
+    restApi->handle("/trackers", HTTP_GET, [trackersData](RestApi::JsonRequest){
+        std::shared_ptr<const json> data = trackersData->get();
+        // Without an ETag, so clients do not keep the empty snapshot
+        if (data->is_null())
+            return getTrackersLoadingResponse();
+        return RestApi::JsonResponse::share(std::move(data));
+    }, [trackersData]{
+        return trackersData->getGeneration();
+    });
+
+    restApi->handle("/trackers", HTTP_PUT, [trackersValueMutex, trackersData](const RestApi::JsonRequest& request){
+        if (!areTrackersLoaded(trackersData))
+            return getTrackersLoadingResponse();
         json responseJson = json::object_t();
+        Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex->get();
         for(const auto& requestJsonItems : request.data.items())
         {
-            Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex->get();
             const std::string& trackerId = requestJsonItems.key();
             if (trackers->find(trackerId) != trackers->end())
             {
@@ -276,41 +367,58 @@ void Api::createTrackerEndpoints(
                 responseJson[trackerId] = tracker.getData();
             }
         }
-        return responseJson;
+        trackersData->publish(getTrackersData(*trackers));
+        return RestApi::JsonResponse(responseJson);
     });
 
-    restApi->handle("/trackers/config", HTTP_GET, [configResource](RestApi::JsonRequest){
-        return getJsonResource(configResource);
+    restApi->handle("/trackers/statistics", HTTP_GET, [trackersValueMutex](RestApi::JsonRequest){
+        return json {
+            {"lockWait", trackersValueMutex->getWaitStatistics().toJson()},
+        };
     });
 
-    restApi->handle("/trackers/config", HTTP_PATCH, [configResource, clock, trackersValueMutex](const RestApi::JsonRequest& request){
-        json configJson = configResource->deserialize();
-        patchJson(configJson, request.data);
-        *trackersValueMutex->get() = Config::configureTrackers(configJson, clock);
+    restApi->handle("/trackers/config", HTTP_GET, [configResource](RestApi::JsonRequest){
+        return getJsonResource(configResource);
+    }, getGeneration(configResource));
+
+    restApi->handle("/trackers/config", HTTP_PATCH, [configResource, clock, trackersValueMutex, trackersData](const RestApi::JsonRequest& request){
+        if (!areTrackersLoaded(trackersData))
+            return getTrackersLoadingResponse();
+        const json currentConfigJson = configResource->deserialize();
+        json configJson = currentConfigJson;
+        if (!Config::getTrackersSchema().patch(&configJson, request.data))
+            return RestApi::JsonResponse(configJson);
+        reconfigureTrackers(currentConfigJson, configJson, clock, trackersValueMutex, trackersData);
         configResource->serialize(configJson);
-        return configJson;
+        return RestApi::JsonResponse(configJson);
     });
 
-    restApi->handle("/trackers/config", HTTP_POST, [configResource, trackersValueMutex, clock](const RestApi::JsonRequest& request){
-        json configJson = configResource->deserialize();
+    restApi->handle("/trackers/config", HTTP_POST, [configResource, trackersValueMutex, trackersData, clock](const RestApi::JsonRequest& request){
+        if (!areTrackersLoaded(trackersData))
+            return getTrackersLoadingResponse();
+        const json currentConfigJson = configResource->deserialize();
+        json configJson = currentConfigJson;
         std::stringstream key;
         key << request.data.at("duration_s") << "_" << request.data.at("sampleCount");
         configJson["trackers"][key.str()] = request.data;
-        *trackersValueMutex->get() = Config::configureTrackers(configJson, clock);
+        reconfigureTrackers(currentConfigJson, configJson, clock, trackersValueMutex, trackersData);
         configResource->serialize(configJson);
         return RestApi::JsonResponse(configJson, 201);
     });
 
     restApi->handle("/trackers/config", HTTP_DELETE,
-        [configResource, trackersValueMutex, clock](const RestApi::JsonRequest& request){
-            json configJson = configResource->deserialize();
+        [configResource, trackersValueMutex, trackersData, clock](const RestApi::JsonRequest& request){
+            if (!areTrackersLoaded(trackersData))
+                return getTrackersLoadingResponse();
+            const json currentConfigJson = configResource->deserialize();
+            json configJson = currentConfigJson;
             for (const json& entry : request.data)
             {
                 const std::string& trackerId = entry;
                 if (!configJson.at("trackers").erase(trackerId))
                     throw std::runtime_error(SOURCE_LOCATION + " \"" + trackerId + "\" is not a valid tracker ID");
             }
-            *trackersValueMutex->get() = Config::configureTrackers(configJson, clock);
+            reconfigureTrackers(currentConfigJson, configJson, clock, trackersValueMutex, trackersData);
             configResource->serialize(configJson);
             return RestApi::JsonResponse(configJson);
         }
@@ -320,11 +428,13 @@ void Api::createTrackerEndpoints(
         return Config::getTrackersDefault();
     });
 
-    restApi->handle("/trackers/config/restore-default", HTTP_POST, [configResource, trackersValueMutex, clock](RestApi::JsonRequest){
+    restApi->handle("/trackers/config/restore-default", HTTP_POST, [configResource, trackersValueMutex, trackersData, clock](RestApi::JsonRequest){
+        if (!areTrackersLoaded(trackersData))
+            return getTrackersLoadingResponse();
         json defaultConfigJson = Config::getTrackersDefault();
-        *trackersValueMutex->get() = Config::configureTrackers(defaultConfigJson, clock);
+        reconfigureTrackers(configResource->deserialize(), defaultConfigJson, clock, trackersValueMutex, trackersData);
         configResource->serialize(defaultConfigJson);
-        return defaultConfigJson;
+        return RestApi::JsonResponse(defaultConfigJson);
     });
 }
 
@@ -333,15 +443,12 @@ void Api::createNetworkEndpoints(RestApi* restApi, JsonResource* configResource)
 {
     restApi->handle("/network/config", HTTP_GET, [configResource](RestApi::JsonRequest){
         return getJsonResource(configResource);
-    });
+    }, getGeneration(configResource));
 
     restApi->handle("/network/config", HTTP_PATCH, [configResource](const RestApi::JsonRequest& request){
         RestApi::JsonResponse response = configResource->deserialize();
-        patchJson(response.data, request.data, {
-            "/version"_json_pointer,
-            "/stationary/macAddress"_json_pointer,
-            "/accesspoint/macAddress"_json_pointer,
-        });
+        if (!Config::getNetworkSchema().patch(&response.data, request.data))
+            return response;
         response.doAfterSend = [configResource, response]{
             json configJson = response.data;
             Config::configureNetwork(&configJson);
@@ -369,4 +476,39 @@ void Api::createNetworkEndpoints(RestApi* restApi, JsonResource* configResource)
     });
 }
 
+
+void Api::createHistoryEndpoints(RestApi* restApi, Rtos::ValueMutex<TimeSeriesStore>* powerHistoryValueMutex) noexcept
+{
+    restApi->handle("/history", HTTP_GET, [powerHistoryValueMutex](const RestApi::JsonRequest& request){
+        int64_t from = INT64_MIN;
+        int64_t to = INT64_MAX;
+        if (request.serverRequest.hasParam("from"))
+            from = strtoll(request.serverRequest.getParam("from")->value().c_str(), nullptr, 10);
+        if (request.serverRequest.hasParam("to"))
+            to = strtoll(request.serverRequest.getParam("to")->value().c_str(), nullptr, 10);
+
+        // Larger ranges are fetched page by page, starting each request at "next"
+        std::vector<GorillaChunk::Point> points = powerHistoryValueMutex->get()->read(from, to, historyPageSize + 1);
+        json responseJson = {
+            {"timestamps", json::array_t()},
+            {"values", json::array_t()},
+        };
+        if (points.size() > historyPageSize)
+        {
+            responseJson["next"] = points.back().timestamp;
+            points.pop_back();
+        }
+        for (const auto& point : points)
+        {
+            responseJson["timestamps"].push_back(point.timestamp);
+            responseJson["values"].push_back(point.value);
+        }
+        return responseJson;
+    });
+
+    restApi->handle("/history/statistics", HTTP_GET, [powerHistoryValueMutex](RestApi::JsonRequest){
+        return powerHistoryValueMutex->get()->getStatistics();
+    });
+}
+
 #endif
\ No newline at end of file
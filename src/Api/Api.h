@@ -1,11 +1,17 @@
 #pragma once
 
 #include "RestAPI/RestAPI.h"
+#include "BootTimeline/BootTimeline.h"
 #include "JsonResource/JsonResource.h"
 #include "MeasuringUnit/MeasuringUnit.h"
+#include "EnergyRegister/EnergyRegister.h"
+#include "TimeSeriesStore/TimeSeriesStore.h"
 #include "Switch/Switch.h"
 #include "Tracker/Tracker.h"
 #include "Rtos/ValueMutex/ValueMutex.h"
+#include "Rtos/SeqLock/SeqLock.h"
+#include "Rtos/PublishedValue/PublishedValue.h"
+#include "Rtos/SafePoint/SafePoint.h"
 
 
 namespace Api
@@ -13,7 +19,8 @@ namespace Api
     void createSystemEndpoints(
         RestApi* restApi,
         const Version& firmwareVersion,
-        const Version& apiVersion
+        const Version& apiVersion,
+        const BootTimeline* bootTimeline
     ) noexcept;
 
     void createLoggerEndpoints(
@@ -32,7 +39,10 @@ namespace Api
         RestApi* restApi,
         JsonResource* configResource,
         MeasuringUnit** measuringUnit,
-        Rtos::ValueMutex<MeasurementList>* measurementsValueMutex
+        Rtos::SafePoint* measuringSafePoint,
+        const Rtos::SeqLock<MeasurementFrame>* measurements,
+        const CycleRing* cycleRing,
+        const EnergyRegister* energyRegister
     ) noexcept;
 
     void createClockEndpoints(
@@ -50,6 +60,12 @@ namespace Api
         RestApi* restApi,
         JsonResource* configResource,
         Rtos::ValueMutex<TrackerMap>* trackersValueMutex,
+        Rtos::PublishedValue<json>* trackersData,
         const Clock* clock
     ) noexcept;
+
+    void createHistoryEndpoints(
+        RestApi* restApi,
+        Rtos::ValueMutex<TimeSeriesStore>* powerHistoryValueMutex
+    ) noexcept;
 };
\ No newline at end of file
@@ -13,10 +13,10 @@ float AverageAccumulator::add(float value, size_t count)
 {
     try
     {
-        Values values = deserialize();
+        Values& values = getValues();
         values.sum += value * count;
         values.count += count;
-        serialize(values);
+        m_unsavedChangeCount++;
         return calculateAverage(values);
     }
     catch (...)
@@ -29,26 +29,44 @@ float AverageAccumulator::add(float value, size_t count)
 
 float AverageAccumulator::getAverage() const noexcept
 {
-    Values values = deserialize();
-    return calculateAverage(values);
+    return calculateAverage(getValues());
 }
 
 
 size_t AverageAccumulator::getCount() const noexcept
 {
-    return deserialize().count;
+    return getValues().count;
 }
 
 
 void AverageAccumulator::reset()
 {
-    serialize(Values(0, 0.0f));
+    m_values = Values(0, 0.0f);
+    m_unsavedChangeCount++;
 }
 
 
 void AverageAccumulator::remove()
 {
     m_storageResource->remove();
+    m_values = Values(0, 0.0f);
+    m_unsavedChangeCount = 0;
+}
+
+
+void AverageAccumulator::checkpoint()
+{
+    if (m_unsavedChangeCount == 0)
+        return;
+
+    serialize(getValues());
+    m_unsavedChangeCount = 0;
+}
+
+
+size_t AverageAccumulator::getUnsavedChangeCount() const noexcept
+{
+    return m_unsavedChangeCount;
 }
 
 
@@ -75,6 +93,14 @@ AverageAccumulator::Values AverageAccumulator::deserialize() const noexcept
 }
 
 
+AverageAccumulator::Values& AverageAccumulator::getValues() const noexcept
+{
+    if (!m_values.has_value())
+        m_values = deserialize();
+    return m_values.value();
+}
+
+
 float AverageAccumulator::calculateAverage(const Values &values) const noexcept
 {
     if(values.count == 0)
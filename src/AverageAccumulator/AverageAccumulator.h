@@ -1,8 +1,11 @@
 #pragma once
 
 #include "JsonResource/JsonResource.h"
+#include <tl/optional.hpp>
 #include <memory>
 
+// Keeps the running sum in RAM. It only reaches the storage resource on checkpoint(),
+// so everything added since the last checkpoint is lost on a power cut.
 class AverageAccumulator
 {
 public:
@@ -12,6 +15,8 @@ public:
     float add(float value, size_t count = 1);
     void reset();
     void remove();
+    void checkpoint();
+    size_t getUnsavedChangeCount() const noexcept;
 
 private:
     struct Values
@@ -23,7 +28,10 @@ private:
 
     void serialize(const Values& values);
     Values deserialize() const noexcept;
+    Values& getValues() const noexcept;
     float calculateAverage(const Values& values) const noexcept;
 
     std::unique_ptr<JsonResource> m_storageResource;
-};
\ No newline at end of file
+    mutable tl::optional<Values> m_values;
+    size_t m_unsavedChangeCount = 0;
+};
@@ -0,0 +1,63 @@
+#include "BootTimeline.h"
+#include "Logger/Logger.h"
+
+
+namespace
+{
+    uint32_t getDuration_ms(BootTimeline::TimePoint start, BootTimeline::TimePoint end) noexcept
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    }
+}
+
+
+BootTimeline::BootTimeline() noexcept :
+    m_start(std::chrono::steady_clock::now()),
+    m_lastMark(m_start)
+{}
+
+
+void BootTimeline::mark(std::string phase)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    TimePoint now = std::chrono::steady_clock::now();
+    addPhase(std::move(phase), m_lastMark, now);
+    m_lastMark = now;
+}
+
+
+void BootTimeline::mark(std::string phase, TimePoint start)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    addPhase(std::move(phase), start, std::chrono::steady_clock::now());
+}
+
+
+json BootTimeline::toJson() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    json phasesJson = json::array_t();
+    for (const auto& phase : m_phases)
+    {
+        phasesJson.push_back({
+            {"name", phase.name},
+            {"duration_ms", phase.duration_ms},
+            {"end_ms", phase.end_ms},
+        });
+    }
+    return phasesJson;
+}
+
+
+void BootTimeline::addPhase(std::string phase, TimePoint start, TimePoint end)
+{
+    Phase newPhase = {
+        .name = std::move(phase),
+        .duration_ms = getDuration_ms(start, end),
+        .end_ms = getDuration_ms(m_start, end),
+    };
+    Logger[LogLevel::Info]
+        << "Boot phase \"" << newPhase.name << "\" took " << newPhase.duration_ms
+        << " ms, finished after " << newPhase.end_ms << " ms." << std::endl;
+    m_phases.push_back(std::move(newPhase));
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <json.hpp>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records how long each phase of the boot took and when it finished, counted from the construction.
+// Phases running in other tasks, like loading the trackers in the background, pass their own start.
+class BootTimeline
+{
+public:
+    using TimePoint = std::chrono::steady_clock::time_point;
+
+    BootTimeline() noexcept;
+    // Finishes a phase, which started with the previous mark
+    void mark(std::string phase);
+    void mark(std::string phase, TimePoint start);
+    json toJson() const;
+
+private:
+    struct Phase
+    {
+        std::string name;
+        uint32_t duration_ms;
+        uint32_t end_ms;
+    };
+
+    void addPhase(std::string phase, TimePoint start, TimePoint end);
+
+    TimePoint m_start;
+    TimePoint m_lastMark;
+    std::vector<Phase> m_phases;
+    mutable std::mutex m_mutex;
+};
\ No newline at end of file
@@ -7,19 +7,11 @@
 #include "Arduino.h"
 
 
-SimulationClock::SimulationClock(const json &configJson)
+SimulationClock::SimulationClock(const Config& config) noexcept :
+    m_startTimestamp(config.startTimestamp),
+    m_fastForward(config.fastForward)
 {
-    try
-    {
-        m_startTimestamp = configJson.at("startTimestamp");
-        m_fastForward = configJson.at("fastForward");
-        Logger[LogLevel::Info] << "Configured simulated clock sucessfully." << std::endl;
-    }
-    catch (...)
-    {
-        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to configure simulated clock");
-        throw;
-    }
+    Logger[LogLevel::Info] << "Configured simulated clock sucessfully." << std::endl;
 }
 
 
@@ -6,11 +6,20 @@
 class SimulationClock : public Clock
 {
 public:
-    SimulationClock(const json& configJson);
+    struct Config
+    {
+        time_t startTimestamp;
+        float fastForward;
+    };
+
+    SimulationClock(const Config& config) noexcept;
 
     time_t now() const noexcept override;
 
 private:
     time_t m_startTimestamp;
     float m_fastForward;
-};
\ No newline at end of file
+};
+
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SimulationClock::Config, startTimestamp, fastForward)
\ No newline at end of file
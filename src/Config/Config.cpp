@@ -8,16 +8,19 @@
 #include "MeasuringUnit/AcMeasuringUnit/AcMeasuringUnit.h"
 #include "MeasuringUnit/SimulationMeasuringUnit/SimulationMeasuringUnit.h"
 #include "JsonResource/BackedUpJsonResource/BackedUpJsonResource.h"
-#include "Filesystem/Directory/LittleFsDirectory/LittleFsDirectory.h"
 #include "Filesystem/File/LittleFsFile/LittleFsFile.h"
 #include "Switch/NoSwitch/NoSwitch.h"
 #include "Switch/Relay/Relay.h"
+#include "TrackerCascade/TrackerCascade.h"
+#include "TrackerStore/BinaryTrackerStore/BinaryTrackerStore.h"
+#include "TrackerStore/JsonTrackerStore/JsonTrackerStore.h"
+#include "TrackerStore/LazyTrackerStore/LazyTrackerStore.h"
 #include "ExceptionTrace/ExceptionTrace.h"
-#include "Version/Version.h"
 #include <Arduino.h>
 #include <WiFi.h>
 #include <LittleFS.h>
 #include <ESPmDNS.h>
+#include <ESPAsyncWebServer.h>
 #include <tl/optional.hpp>
 #include <fstream>
 #include <functional>
@@ -25,15 +28,20 @@
 
 namespace
 {
+    // Runtime state is only read by the firmware, so it is stored compact. Configs stay readable text.
+    constexpr BasicJsonResource::Encoding stateEncoding = BasicJsonResource::Encoding::Cbor;
+
+
     template<typename T>
     using ImplementationMap = std::unordered_map<std::string, std::function<T*(const json&)>>;
 
 
-    template<typename T>
+    // Implementations without options take the JSON as is
+    template<typename T, typename TConfig = typename T::Config>
     T* configureImplementation(const json& configJson)
     {
         static tl::optional<T> implementation;
-        implementation.emplace(configJson);
+        implementation.emplace(configJson.get<TConfig>());
         return &implementation.value();
     }
 
@@ -63,67 +71,141 @@ namespace
     }
 
 
-    LogStream configureLogStream(const json& configJson, std::ostream* stream)
+    LogStream configureLogStream(const Config::LogStreamConfig& config, std::ostream* stream)
     {
-        LogLevel minLevel = configJson.at("minLevel").get<std::string>();
-        LogLevel maxLevel = configJson.at("maxLevel").get<std::string>();
-        bool showLevel = configJson.at("showLevel");
-        return LogStream(minLevel, maxLevel, stream, showLevel);
+        return LogStream(LogLevel(config.minLevel), LogLevel(config.maxLevel), stream, config.showLevel);
     }
 
 
-    json getConfigJson(JsonResource* configResource, const json& defaultConfigJson)
+    std::unique_ptr<TrackerStore> createTrackerStore(const std::string& trackerDirectoryPath, size_t sampleCount)
     {
+        std::unique_ptr<Filesystem::File> dataFile(new Filesystem::LittleFsFile(trackerDirectoryPath + "/data.bin"));
+        bool isMigrationNeeded = !dataFile->exists();
+        std::unique_ptr<TrackerStore> dataStore(new BinaryTrackerStore(std::move(dataFile), sampleCount));
+        if (!isMigrationNeeded)
+            return dataStore;
+
+        // Take over the data of trackers created before the binary store existed
         try
         {
-            json configJson = configResource->deserializeOrGet([&configResource, &defaultConfigJson]{
-                Logger[LogLevel::Info] << "Failed to deserialize config. Using default config." << std::endl;
-                configResource->serialize(defaultConfigJson);
-                return defaultConfigJson;
-            });
-
-            Version installedVersion(configJson.at("version"));
-            Version latestVersion(defaultConfigJson.at("version"));
-            if (installedVersion.major != latestVersion.major)
+            JsonTrackerStore legacyDataStore(
+                std::unique_ptr<JsonResource>(
+                    new BackedUpJsonResource(
+                        BasicJsonResource(
+                            std::unique_ptr<Filesystem::File>(
+                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/data.a.json")
+                            )
+                        ),
+                        BasicJsonResource(
+                            std::unique_ptr<Filesystem::File>(
+                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/data.b.json")
+                            )
+                        )
+                    )
+                ),
+                sampleCount
+            );
+            json legacyData = legacyDataStore.getData();
+            if (legacyData.is_array())
             {
-                Logger[LogLevel::Info]
-                    << "Version of current config (v"
-                    << installedVersion
-                    <<") is not compatible. Changing to v"
-                    << latestVersion
-                    << "."
-                    << std::endl;
-                configResource->serialize(defaultConfigJson);
-                return defaultConfigJson;
+                dataStore->setData(legacyData);
+                Logger[LogLevel::Info] << "Migrated \"" << trackerDirectoryPath << "\" to binary data." << std::endl;
             }
-            return configJson;
+            legacyDataStore.remove();
         }
         catch (...)
         {
-            ExceptionTrace::trace(SOURCE_LOCATION + "Failed to get config Json");
-            throw;
+            ExceptionTrace::clear();
         }
+        return dataStore;
     }
-}
 
+    Tracker::CheckpointPolicy getCheckpointPolicy(const json& configJson)
+    {
+        json checkpointJson = configJson.value("checkpoint", Config::getTrackersDefault().at("checkpoint"));
+        return Tracker::CheckpointPolicy{
+            .interval_s = checkpointJson.at("interval_s"),
+            .maxUnsavedInputCount = checkpointJson.at("maxUnsavedInputCount"),
+        };
+    }
 
-json Config::getLoggerDefault() noexcept
-{
-    return {
-        {"version", "0.0.0"},
-        {"file", {
-            {"filePath", "/Log/log.log"},
-            {"showLevel", true},
-            {"minLevel", "Error"},
-            {"maxLevel", "Verbose"},
-        }},
-        {"console", {
-            {"baudRate", 115200},
-            {"showLevel", true},
-            {"minLevel", "Error"},
-            {"maxLevel", "Verbose"},
-        }},
-    };
+
+    Tracker createTracker(
+        const std::string& trackerId,
+        const json& trackerJson,
+        const Clock* clock,
+        Tracker::CheckpointPolicy checkpointPolicy
+    )
+    {
+        std::string trackerDirectoryPath = "/Trackers/" + trackerId;
+        size_t sampleCount = trackerJson.at("sampleCount");
+        return Tracker(
+            trackerJson.at("title"),
+            trackerJson.at("duration_s"),
+            sampleCount,
+            clock,
+            std::unique_ptr<TrackerStore>(new LazyTrackerStore([trackerDirectoryPath, sampleCount]{
+                return createTrackerStore(trackerDirectoryPath, sampleCount);
+            })),
+            std::unique_ptr<JsonResource>(
+                new BackedUpJsonResource(
+                    BasicJsonResource(
+                        std::unique_ptr<Filesystem::File>(
+                            new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastInputTimestamp.a.json")
+                        ),
+                        true,
+                        stateEncoding
+                    ),
+                    BasicJsonResource(
+                        std::unique_ptr<Filesystem::File>(
+                            new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastInputTimestamp.b.json")
+                        ),
+                        true,
+                        stateEncoding
+                    )
+                )
+            ),
+            std::unique_ptr<JsonResource>(
+                new BackedUpJsonResource(
+                    BasicJsonResource(
+                        std::unique_ptr<Filesystem::File>(
+                            new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastSampleTimestamp.a.json")
+                        ),
+                        true,
+                        stateEncoding
+                    ),
+                    BasicJsonResource(
+                        std::unique_ptr<Filesystem::File>(
+                            new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastSampleTimestamp.b.json")
+                        ),
+                        true,
+                        stateEncoding
+                    )
+                )
+            ),
+            AverageAccumulator(
+                std::unique_ptr<JsonResource>(
+                    new BackedUpJsonResource(
+                        BasicJsonResource(
+                            std::unique_ptr<Filesystem::File>(
+                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/accumulator.a.json")
+                            ),
+                            true,
+                            stateEncoding
+                        ),
+                        BasicJsonResource(
+                            std::unique_ptr<Filesystem::File>(
+                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/accumulator.b.json")
+                            ),
+                            true,
+                            stateEncoding
+                        )
+                    )
+                )
+            ),
+            checkpointPolicy
+        );
+    }
 }
 
 
@@ -131,7 +213,7 @@ void Config::configureLogger(JsonResource* configResource, AsyncWebServer* serve
 {
     try
     {
-        configureLogger(getConfigJson(configResource, getLoggerDefault()), server);
+        configureLogger(loadConfig(configResource, getLoggerDefault(), getLoggerSchema()), server);
     }
     catch (...)
     {
@@ -146,9 +228,11 @@ void Config::configureLogger(const json& configJson, AsyncWebServer* server)
     Logger[LogLevel::Info] << "Configuring Logger..." << std::endl;
     try
     {
-        Serial.begin(configJson.at("/console/baudRate"_json_pointer));
+        getLoggerSchema().validate(configJson);
+        LoggerConfig config = configJson.get<LoggerConfig>();
+        Serial.begin(config.console.baudRate);
 
-        std::string logFilePath = configJson.at("/file/filePath"_json_pointer);
+        std::string logFilePath = config.file.filePath;
 
         server->on("/log", HTTP_GET, [logFilePath](AsyncWebServerRequest* request){
             request->send(LittleFS, logFilePath.c_str(), "text/plain");
@@ -171,8 +255,8 @@ void Config::configureLogger(const json& configJson, AsyncWebServer* server)
         static std::ostream logFileStream(&logFileBuffer);
 
         std::vector<LogStream> logStreams = {
-            configureLogStream(configJson.at("console"), &std::cout),
-            configureLogStream(configJson.at("file"), &logFileStream),
+            configureLogStream(config.console, &std::cout),
+            configureLogStream(config.file, &logFileStream),
         };
         Logger = logStreams;
         Logger[LogLevel::Info] << "Logger configured sucessfully." << std::endl;
@@ -185,48 +269,11 @@ void Config::configureLogger(const json& configJson, AsyncWebServer* server)
 }
 
 
-json Config::getMeasuringDefault() noexcept
-{
-    return {
-        {"version", "0.0.0"},
-        {"selected", "Ac"},
-        {"options", {
-            {"Simulation", {
-                {"measuringRunTime_ms", 0},
-                {"voltage", {
-                    {"min", 220},
-                    {"max", 240},
-                }},
-                {"current", {
-                    {"min", 0.01},
-                    {"max", 16},
-                }},
-                {"powerFactor", {
-                    {"min", 0.5},
-                    {"max", 1},
-                }},
-            }},
-            {"Ac", {
-                {"pins", {
-                    {"voltage", 33},
-                    {"current", 32},
-                }},
-                {"calibration", {
-                    {"voltage", 536.9},
-                    {"current", 15.7},
-                    {"phase", -5.6},
-                }},
-            }},
-        }},
-    };
-}
-
-
 MeasuringUnit* Config::configureMeasuring(JsonResource* configResource)
 {
     try
     {
-        return configureMeasuring(getConfigJson(configResource, getMeasuringDefault()));
+        return configureMeasuring(loadConfig(configResource, getMeasuringDefault(), getMeasuringSchema()));
     }
     catch (...)
     {
@@ -241,6 +288,7 @@ MeasuringUnit* Config::configureMeasuring(const json& configJson)
     Logger[LogLevel::Info] << "Configuring measuring unit..." << std::endl;
     try
     {
+        getMeasuringSchema().validate(configJson);
         ImplementationMap<MeasuringUnit> measuringUnits = {
             {"Ac", configureImplementation<AcMeasuringUnit>},
             {"Simulation", configureImplementation<SimulationMeasuringUnit>},
@@ -255,27 +303,11 @@ MeasuringUnit* Config::configureMeasuring(const json& configJson)
 }
 
 
-json Config::getClockDefault() noexcept
-{
-    return {
-        {"version", "0.0.0"},
-        {"selected", "DS3231"},
-        {"options", {
-            {"Simulation", {
-                {"startTimestamp", 0},
-                {"fastForward", 1},
-            }},
-            {"DS3231", nullptr},
-        }},
-    };
-}
-
-
 Clock* Config::configureClock(JsonResource* configResource)
 {
     try
     {
-        return configureClock(getConfigJson(configResource, getClockDefault()));
+        return configureClock(loadConfig(configResource, getClockDefault(), getClockSchema()));
     }
     catch (...)
     {
@@ -290,8 +322,9 @@ Clock* Config::configureClock(const json& configJson)
     Logger[LogLevel::Info] << "Configuring clock..." << std::endl;
     try
     {
+        getClockSchema().validate(configJson);
         ImplementationMap<Clock> clocks = {
-            {"DS3231", configureImplementation<DS3231>},
+            {"DS3231", configureImplementation<DS3231, json>},
             {"Simulation", configureImplementation<SimulationClock>},
         };
         return getSelectedImplementation<Clock>(configJson, clocks);
@@ -304,27 +337,11 @@ Clock* Config::configureClock(const json& configJson)
 }
 
 
-json Config::getSwitchDefault() noexcept
-{
-    return {
-        {"version", "0.0.0"},
-        {"selected", "Relay"},
-        {"options", {
-            {"Relay", {
-                {"pin", 2},
-                {"isNormallyOpen", true},
-            }},
-            {"None", nullptr},
-        }},
-    };
-}
-
-
 Switch* Config::configureSwitch(JsonResource* configResource)
 {
     try
     {
-        return configureSwitch(getConfigJson(configResource, getSwitchDefault()));
+        return configureSwitch(loadConfig(configResource, getSwitchDefault(), getSwitchSchema()));
     }
     catch (...)
     {
@@ -339,8 +356,9 @@ Switch* Config::configureSwitch(const json& configJson)
     Logger[LogLevel::Info] << "Configuring switch..." << std::endl;
     try
     {
+        getSwitchSchema().validate(configJson);
         ImplementationMap<Switch> switches = {
-            {"None", configureImplementation<NoSwitch>},
+            {"None", configureImplementation<NoSwitch, json>},
             {"Relay", configureImplementation<Relay>},
         };
         Switch* switchUnit = getSelectedImplementation<Switch>(configJson, switches);
@@ -354,46 +372,35 @@ Switch* Config::configureSwitch(const json& configJson)
 }
 
 
-json Config::getTrackersDefault() noexcept
+TrackerMap Config::configureTrackers(JsonResource* configResource, const Clock* clock)
 {
-    return {
-        {"version", "0.0.0"},
-        {"trackers", {
-            {"3600_60", {
-                {"title", "Last 60 Minutes"},
-                {"duration_s", 3600},
-                {"sampleCount", 60},
-            }},
-            {"86400_24", {
-                {"title", "Last 24 Hours"},
-                {"duration_s", 86400},
-                {"sampleCount", 24},
-            }},
-            {"604800_7", {
-                {"title", "Last 7 Days"},
-                {"duration_s", 604800},
-                {"sampleCount", 7},
-            }},
-            {"2592000_30", {
-                {"title", "Last 30 Days"},
-                {"duration_s", 2592000},
-                {"sampleCount", 30},
-            }},
-            {"31104000_12", {
-                {"title", "Last 12 Months"},
-                {"duration_s", 31104000},
-                {"sampleCount", 12},
-            }},
-        }},
-    };
+    try
+    {
+        return configureTrackers(loadConfig(configResource, getTrackersDefault(), getTrackersSchema()), clock);
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to configure trackers");
+        throw;
+    }
 }
 
 
-TrackerMap Config::configureTrackers(JsonResource* configResource, const Clock* clock)
+TrackerMap Config::configureTrackers(const json& configJson, const Clock* clock)
 {
+    Logger[LogLevel::Info] << "Configuring trackers..." << std::endl;
     try
     {
-        return configureTrackers(getConfigJson(configResource, getTrackersDefault()), clock);
+        getTrackersSchema().validate(configJson);
+        Tracker::CheckpointPolicy checkpointPolicy = getCheckpointPolicy(configJson);
+        TrackerMap trackers;
+        for(const auto& trackerJson : configJson.at("trackers").items())
+            trackers.insert(std::make_pair(trackerJson.key(), createTracker(trackerJson.key(), trackerJson.value(), clock, checkpointPolicy)));
+        if (configJson.value("cascade", false))
+            TrackerCascade::build(trackers);
+
+        Logger[LogLevel::Info] << "Trackers configured sucessfully." << std::endl;
+        return trackers;
     }
     catch (...)
     {
@@ -403,107 +410,66 @@ TrackerMap Config::configureTrackers(JsonResource* configResource, const Clock*
 }
 
 
-TrackerMap Config::configureTrackers(const json& configJson, const Clock* clock)
+TrackerMap Config::prepareTrackers(const TrackerReconciliation::Plan& plan, const json& configJson, const Clock* clock)
 {
-    Logger[LogLevel::Info] << "Configuring trackers..." << std::endl;
     try
     {
-        Filesystem::LittleFsDirectory trackersDirectory("/Trackers");
-        Filesystem::Directory::Entries toBeRemovedEntries;
-        try
+        getTrackersSchema().validate(configJson);
+        Tracker::CheckpointPolicy checkpointPolicy = getCheckpointPolicy(configJson);
+        const json& trackersJson = configJson.at("trackers");
+        TrackerMap preparedTrackers;
+        for (const std::vector<std::string>* trackerIds : {&plan.createdIds, &plan.replacedIds})
         {
-            toBeRemovedEntries = trackersDirectory.getEntries();
+            for (const auto& trackerId : *trackerIds)
+            {
+                Logger[LogLevel::Info] << "Creating tracker \"" << trackerId << "\"..." << std::endl;
+                preparedTrackers.insert(std::make_pair(trackerId, createTracker(trackerId, trackersJson.at(trackerId), clock, checkpointPolicy)));
+            }
         }
-        catch (...)
-        {}
+        return preparedTrackers;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to prepare trackers");
+        throw;
+    }
+}
 
-        TrackerMap trackers;
-        for(const auto& trackerJson : configJson.at("trackers").items())
-        {
-            std::string trackerId = trackerJson.key();
-            Filesystem::Directory::Entries::iterator toBeKeptEntryPosition = std::find_if(
-                toBeRemovedEntries.begin(),
-                toBeRemovedEntries.end(),
-                [trackerId](const std::unique_ptr<Filesystem::Entry>& entry){
-                    return entry->getName() == trackerId;
-                }
-            );
-            if (toBeKeptEntryPosition != toBeRemovedEntries.end())
-                toBeRemovedEntries.erase(toBeKeptEntryPosition);
 
-            std::string trackerDirectoryPath = trackersDirectory.getPath() + '/' + trackerId;
+TrackerMap Config::reconfigureTrackers(
+    TrackerMap* trackers,
+    const TrackerReconciliation::Plan& plan,
+    TrackerMap preparedTrackers,
+    const json& configJson
+)
+{
+    Logger[LogLevel::Info] << "Reconfiguring trackers..." << std::endl;
+    try
+    {
+        Tracker::CheckpointPolicy checkpointPolicy = getCheckpointPolicy(configJson);
+        TrackerMap removedTrackers = TrackerReconciliation::apply(*trackers, plan, std::move(preparedTrackers));
+        for (const auto& trackerId : plan.keptIds)
+        {
+            TrackerMap::iterator tracker = trackers->find(trackerId);
+            if (tracker != trackers->end())
+                tracker->second.setCheckpointPolicy(checkpointPolicy);
+        }
 
-            trackers.insert(std::make_pair<std::string, Tracker>(std::move(trackerId), Tracker(
-                trackerJson.value().at("title"),
-                trackerJson.value().at("duration_s"),
-                trackerJson.value().at("sampleCount"),
-                clock,
-                std::unique_ptr<JsonResource>(
-                    new BackedUpJsonResource(
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/data.a.json")
-                            )
-                        ),
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                               new Filesystem::LittleFsFile(trackerDirectoryPath + "/data.b.json")
-                            )
-                        )
-                    )
-                ),
-                std::unique_ptr<JsonResource>(
-                    new BackedUpJsonResource(
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastInputTimestamp.a.json")
-                            )
-                        ),
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastInputTimestamp.b.json")
-                            )
-                        )
-                    )
-                ),
-                std::unique_ptr<JsonResource>(
-                    new BackedUpJsonResource(
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastSampleTimestamp.a.json")
-                            )
-                        ),
-                        BasicJsonResource(
-                            std::unique_ptr<Filesystem::File>(
-                                new Filesystem::LittleFsFile(trackerDirectoryPath + "/lastSampleTimestamp.b.json")
-                            )
-                        )
-                    )
-                ),
-                AverageAccumulator(
-                    std::unique_ptr<JsonResource>(
-                        new BackedUpJsonResource(
-                            BasicJsonResource(
-                                std::unique_ptr<Filesystem::File>(
-                                    new Filesystem::LittleFsFile(trackerDirectoryPath + "/accumulator.a.json")
-                                )
-                            ),
-                            BasicJsonResource(
-                                std::unique_ptr<Filesystem::File>(
-                                    new Filesystem::LittleFsFile(trackerDirectoryPath + "/accumulator.b.json")
-                                )
-                            )
-                        )
-                    )
-                )
-            )));
+        if (configJson.value("cascade", false))
+        {
+            TrackerCascade::build(*trackers);
         }
-        Logger[LogLevel::Info] << "Trackers configured sucessfully." << std::endl;
-        return trackers;
+        else
+        {
+            for (auto& tracker : *trackers)
+                tracker.second.clearCascade();
+        }
+        Logger[LogLevel::Info] << "Trackers reconfigured sucessfully." << std::endl;
+        return removedTrackers;
     }
     catch (...)
     {
-        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to configure trackers");
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to reconfigure trackers");
         throw;
     }
 }
@@ -544,11 +510,22 @@ json Config::getNetworkDefault() noexcept
 }
 
 
+const ConfigSchema& Config::getNetworkSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .readonly("/stationary/macAddress")
+        .readonly("/accesspoint/macAddress")
+        .oneOf("/stationary/ipMode", {"DHCP", "Static"});
+    return schema;
+}
+
+
 void Config::configureNetwork(JsonResource* configResource)
 {
     try
     {
-        json configJson = getConfigJson(configResource, getNetworkDefault());
+        json configJson = loadConfig(configResource, getNetworkDefault(), getNetworkSchema());
         configureNetwork(&configJson);
         configResource->serialize(configJson);
     }
@@ -565,6 +542,7 @@ void Config::configureNetwork(json* configJson)
     Logger[LogLevel::Info] << "Configuring network..." << std::endl;
     try
     {
+        getNetworkSchema().validate(*configJson);
         const std::string& hostname = configJson->at("hostname");;
         WiFi.setHostname(hostname.c_str());
 
@@ -1,37 +1,86 @@
 #pragma once
 
 #include "JsonResource/JsonResource.h"
+#include "ConfigSchema/ConfigSchema.h"
 #include "MeasuringUnit/MeasuringUnit.h"
 #include "Tracker/Tracker.h"
+#include "TrackerReconciliation/TrackerReconciliation.h"
 #include "Clock/Clock.h"
 #include "Switch/Switch.h"
-#include <ESPAsyncWebServer.h>
 #include <vector>
 
+class AsyncWebServer;
+
 
 namespace Config
 {
+    struct LogStreamConfig
+    {
+        bool showLevel;
+        std::string minLevel;
+        std::string maxLevel;
+    };
+
+    struct LoggerConfig
+    {
+        struct Console : public LogStreamConfig
+        {
+            uint32_t baudRate;
+        };
+
+        struct File : public LogStreamConfig
+        {
+            std::string filePath;
+        };
+
+        Console console;
+        File file;
+    };
+
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LoggerConfig::Console, baudRate, showLevel, minLevel, maxLevel)
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LoggerConfig::File, filePath, showLevel, minLevel, maxLevel)
+    NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(LoggerConfig, console, file)
+
+    // Reads a stored config. One of another major version is replaced by the default, values out of range are
+    // clamped, in both cases the result is stored again.
+    json loadConfig(JsonResource* configResource, const json& defaultConfigJson, const ConfigSchema& schema);
+
     json getLoggerDefault() noexcept;
+    const ConfigSchema& getLoggerSchema() noexcept;
     void configureLogger(JsonResource* configResource, AsyncWebServer* server);
     void configureLogger(const json& configJson, AsyncWebServer* server);
 
     json getMeasuringDefault() noexcept;
+    const ConfigSchema& getMeasuringSchema() noexcept;
     MeasuringUnit* configureMeasuring(JsonResource* configResource);
     MeasuringUnit* configureMeasuring(const json& configJson);
 
     json getClockDefault() noexcept;
+    const ConfigSchema& getClockSchema() noexcept;
     Clock* configureClock(JsonResource* configResource);
     Clock* configureClock(const json& configJson);
 
     json getSwitchDefault() noexcept;
+    const ConfigSchema& getSwitchSchema() noexcept;
     Switch* configureSwitch(JsonResource* configResource);
     Switch* configureSwitch(const json& configJson);
 
     json getTrackersDefault() noexcept;
+    const ConfigSchema& getTrackersSchema() noexcept;
     TrackerMap configureTrackers(JsonResource* configResource, const Clock* clock);
     TrackerMap configureTrackers(const json& configJson, const Clock* clock);
+    // Builds the trackers a config change creates or replaces, without touching the running ones
+    TrackerMap prepareTrackers(const TrackerReconciliation::Plan& plan, const json& configJson, const Clock* clock);
+    // Swaps the prepared trackers in and hands back the removed ones, whose files are left to be erased
+    TrackerMap reconfigureTrackers(
+        TrackerMap* trackers,
+        const TrackerReconciliation::Plan& plan,
+        TrackerMap preparedTrackers,
+        const json& configJson
+    );
 
     json getNetworkDefault() noexcept;
+    const ConfigSchema& getNetworkSchema() noexcept;
     void configureNetwork(JsonResource* configResource);
     void configureNetwork(json* configJson);
 }
@@ -0,0 +1,259 @@
+#include "Config.h"
+#include "Logger/Logger.h"
+#include "SourceLocation/SourceLocation.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "Version/Version.h"
+#include <vector>
+
+// Loading, defaults and schemas of the configs. Unlike configuring the hardware, they build for every target,
+// so migrating stored configs can be tested on the PC. The network default depends on the chip, it stays in Config.cpp.
+
+namespace
+{
+    // ADC1 pins, ADC2 can not be sampled by I2S
+    const std::vector<uint8_t> adcPins = {32, 33, 34, 35, 36, 37, 38, 39};
+    // Pins, which can drive an output and are not taken by the flash
+    const std::vector<uint8_t> outputPins = {0, 2, 4, 5, 12, 13, 14, 15, 16, 17, 18, 19, 21, 22, 23, 25, 26, 27, 32, 33};
+    const std::vector<json> logLevels = {"Error", "Warning", "Debug", "Info", "Verbose"};
+}
+
+
+json Config::loadConfig(JsonResource* configResource, const json& defaultConfigJson, const ConfigSchema& schema)
+{
+    try
+    {
+        json configJson = configResource->deserializeOrGet([&configResource, &defaultConfigJson]{
+            Logger[LogLevel::Info] << "Failed to deserialize config. Using default config." << std::endl;
+            configResource->serialize(defaultConfigJson);
+            return defaultConfigJson;
+        });
+
+        Version installedVersion(configJson.at("version"));
+        Version latestVersion(defaultConfigJson.at("version"));
+        if (installedVersion.major != latestVersion.major)
+        {
+            Logger[LogLevel::Info]
+                << "Version of current config (v"
+                << installedVersion
+                <<") is not compatible. Changing to v"
+                << latestVersion
+                << "."
+                << std::endl;
+            configResource->serialize(defaultConfigJson);
+            return defaultConfigJson;
+        }
+
+        // Compatible configs of older firmware may hold values, which are out of today's ranges
+        if (schema.clamp(&configJson))
+        {
+            Logger[LogLevel::Warning]
+                << "Config v" << installedVersion << " had values out of range, they were moved to the nearest bound."
+                << std::endl;
+            configResource->serialize(configJson);
+        }
+        return configJson;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to get config Json");
+        throw;
+    }
+}
+
+
+json Config::getLoggerDefault() noexcept
+{
+    return {
+        {"version", "0.0.0"},
+        {"file", {
+            {"filePath", "/Log/log.log"},
+            {"showLevel", true},
+            {"minLevel", "Error"},
+            {"maxLevel", "Verbose"},
+        }},
+        {"console", {
+            {"baudRate", 115200},
+            {"showLevel", true},
+            {"minLevel", "Error"},
+            {"maxLevel", "Verbose"},
+        }},
+    };
+}
+
+
+const ConfigSchema& Config::getLoggerSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .integerRange("/console/baudRate", 300, 5000000)
+        .oneOf("/console/minLevel", logLevels)
+        .oneOf("/console/maxLevel", logLevels)
+        .oneOf("/file/minLevel", logLevels)
+        .oneOf("/file/maxLevel", logLevels);
+    return schema;
+}
+
+
+json Config::getMeasuringDefault() noexcept
+{
+    return {
+        {"version", "0.1.0"},
+        {"selected", "Ac"},
+        {"options", {
+            {"Simulation", {
+                {"measuringRunTime_ms", 1000},
+                {"voltage", {
+                    {"min", 220},
+                    {"max", 240},
+                }},
+                {"current", {
+                    {"min", 0.01},
+                    {"max", 16},
+                }},
+                {"powerFactor", {
+                    {"min", 0.5},
+                    {"max", 1},
+                }},
+            }},
+            {"Ac", {
+                {"pins", {
+                    {"voltage", 33},
+                    {"current", 32},
+                }},
+                {"calibration", {
+                    {"voltage", 536.9},
+                    {"current", 15.7},
+                    {"phase", -5.6},
+                }},
+                {"halfCycles", false},
+            }},
+        }},
+    };
+}
+
+
+const ConfigSchema& Config::getMeasuringSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .oneOf("/selected", {"Ac", "Simulation"})
+        .selectable("/options", "/selected")
+        .integerRange("/options/Simulation/measuringRunTime_ms", 20, 60000)
+        .range("/options/Simulation/voltage/*", 0, 1000)
+        .range("/options/Simulation/current/*", 0, 100)
+        .range("/options/Simulation/powerFactor/*", -1, 1)
+        .pin("/options/Ac/pins/voltage", adcPins)
+        .pin("/options/Ac/pins/current", adcPins)
+        .range("/options/Ac/calibration/voltage", 1, 10000)
+        .range("/options/Ac/calibration/current", 0.1, 1000)
+        .range("/options/Ac/calibration/phase", -50, 50);
+    return schema;
+}
+
+
+json Config::getClockDefault() noexcept
+{
+    return {
+        {"version", "0.0.0"},
+        {"selected", "DS3231"},
+        {"options", {
+            {"Simulation", {
+                {"startTimestamp", 0},
+                {"fastForward", 1},
+            }},
+            {"DS3231", nullptr},
+        }},
+    };
+}
+
+
+const ConfigSchema& Config::getClockSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .oneOf("/selected", {"DS3231", "Simulation"})
+        .selectable("/options", "/selected")
+        .integerRange("/options/Simulation/startTimestamp", 0, INT32_MAX)
+        .range("/options/Simulation/fastForward", 0, 1000000);
+    return schema;
+}
+
+
+json Config::getSwitchDefault() noexcept
+{
+    return {
+        {"version", "0.0.0"},
+        {"selected", "Relay"},
+        {"options", {
+            {"Relay", {
+                {"pin", 2},
+                {"isNormallyOpen", true},
+            }},
+            {"None", nullptr},
+        }},
+    };
+}
+
+
+const ConfigSchema& Config::getSwitchSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .oneOf("/selected", {"Relay", "None"})
+        .selectable("/options", "/selected")
+        .pin("/options/Relay/pin", outputPins);
+    return schema;
+}
+
+
+json Config::getTrackersDefault() noexcept
+{
+    return {
+        {"version", "0.2.0"},
+        {"cascade", true},
+        // Bounds the flash writes as well as the inputs lost on a power cut
+        {"checkpoint", {
+            {"interval_s", 300},
+            {"maxUnsavedInputCount", 300},
+        }},
+        {"trackers", {
+            {"3600_60", {
+                {"title", "Last 60 Minutes"},
+                {"duration_s", 3600},
+                {"sampleCount", 60},
+            }},
+            {"86400_24", {
+                {"title", "Last 24 Hours"},
+                {"duration_s", 86400},
+                {"sampleCount", 24},
+            }},
+            {"604800_7", {
+                {"title", "Last 7 Days"},
+                {"duration_s", 604800},
+                {"sampleCount", 7},
+            }},
+            {"2592000_30", {
+                {"title", "Last 30 Days"},
+                {"duration_s", 2592000},
+                {"sampleCount", 30},
+            }},
+            {"31104000_12", {
+                {"title", "Last 12 Months"},
+                {"duration_s", 31104000},
+                {"sampleCount", 12},
+            }},
+        }},
+    };
+}
+
+
+const ConfigSchema& Config::getTrackersSchema() noexcept
+{
+    static const ConfigSchema schema = ConfigSchema()
+        .readonly("/version")
+        .integerRange("/checkpoint/interval_s", 1, 86400)
+        .integerRange("/checkpoint/maxUnsavedInputCount", 1, 100000)
+        .integerRange("/trackers/*/duration_s", 1, INT32_MAX)
+        .integerRange("/trackers/*/sampleCount", 1, 1440);
+    return schema;
+}
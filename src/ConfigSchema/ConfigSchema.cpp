@@ -0,0 +1,302 @@
+#include "ConfigSchema.h"
+#include "SourceLocation/SourceLocation.h"
+#include <algorithm>
+
+
+namespace
+{
+    std::vector<std::string> splitPath(const std::string& path)
+    {
+        std::vector<std::string> tokens;
+        json::json_pointer pointer(path);
+        while (!pointer.empty())
+        {
+            tokens.push_back(pointer.back());
+            pointer.pop_back();
+        }
+        std::reverse(tokens.begin(), tokens.end());
+        return tokens;
+    }
+
+
+    std::string joinPath(const std::vector<std::string>& tokens)
+    {
+        json::json_pointer pointer;
+        for (const auto& token : tokens)
+            pointer.push_back(token);
+        return '"' + pointer.to_string() + '"';
+    }
+
+
+    bool isMatching(const std::vector<std::string>& ruleTokens, const std::vector<std::string>& tokens)
+    {
+        if (ruleTokens.size() != tokens.size())
+            return false;
+        for (size_t i = 0; i < tokens.size(); i++)
+        {
+            if (ruleTokens[i] != "*" && ruleTokens[i] != tokens[i])
+                return false;
+        }
+        return true;
+    }
+
+
+    std::string formatBound(double bound)
+    {
+        if (bound == static_cast<double>(static_cast<int64_t>(bound)))
+            return std::to_string(static_cast<int64_t>(bound));
+        return json(bound).dump();
+    }
+
+
+    void checkType(const json& target, const json& value, const std::vector<std::string>& tokens)
+    {
+        // Integers and floats are not told apart here, that is up to the rules
+        if (target.is_number() && value.is_number())
+            return;
+        if (target.type() != value.type())
+        {
+            throw std::runtime_error(
+                SOURCE_LOCATION + joinPath(tokens) + " must be of type " + target.type_name() + ", not " + value.type_name()
+            );
+        }
+    }
+}
+
+
+ConfigSchema& ConfigSchema::readonly(const std::string& path)
+{
+    return addRule(RuleType::Readonly, path, 0, 0, {});
+}
+
+
+ConfigSchema& ConfigSchema::range(const std::string& path, double min, double max)
+{
+    return addRule(RuleType::Range, path, min, max, {});
+}
+
+
+ConfigSchema& ConfigSchema::integerRange(const std::string& path, int64_t min, int64_t max)
+{
+    return addRule(RuleType::IntegerRange, path, min, max, {});
+}
+
+
+ConfigSchema& ConfigSchema::oneOf(const std::string& path, std::vector<json> values)
+{
+    return addRule(RuleType::OneOf, path, 0, 0, std::move(values));
+}
+
+
+ConfigSchema& ConfigSchema::pin(const std::string& path, std::vector<uint8_t> pins)
+{
+    return addRule(RuleType::Pin, path, 0, 0, std::vector<json>(pins.begin(), pins.end()));
+}
+
+
+ConfigSchema& ConfigSchema::selectable(const std::string& optionsPath, const std::string& selectedPath)
+{
+    m_optionsTokens = splitPath(optionsPath);
+    m_selectedPointer = json::json_pointer(selectedPath);
+    return *this;
+}
+
+
+void ConfigSchema::validate(const json& config) const
+{
+    std::vector<std::string> tokens;
+    for (const auto& rule : m_rules)
+    {
+        if (rule.type != RuleType::Readonly && !isUnselected(rule, config))
+            validateMatches(rule, config, tokens);
+    }
+}
+
+
+bool ConfigSchema::clamp(json* config) const
+{
+    std::vector<std::string> tokens;
+    bool isChanged = false;
+    for (const auto& rule : m_rules)
+    {
+        if (rule.type == RuleType::Range || rule.type == RuleType::IntegerRange)
+            isChanged = clampMatches(rule, *config, tokens) || isChanged;
+    }
+    return isChanged;
+}
+
+
+bool ConfigSchema::patch(json* target, const json& patch) const
+{
+    std::vector<std::string> tokens;
+    return patchValue(*target, patch, tokens);
+}
+
+
+ConfigSchema& ConfigSchema::addRule(RuleType type, const std::string& path, double min, double max, std::vector<json> values)
+{
+    m_rules.push_back(Rule{type, splitPath(path), min, max, std::move(values)});
+    return *this;
+}
+
+
+bool ConfigSchema::patchValue(json& target, const json& patch, std::vector<std::string>& tokens) const
+{
+    checkReadonly(target, patch, tokens);
+    if (!target.is_object() || !patch.is_object())
+    {
+        checkType(target, patch, tokens);
+        for (const auto& rule : m_rules)
+        {
+            if (rule.type != RuleType::Readonly && isMatching(rule.tokens, tokens))
+                checkRule(rule, patch, tokens);
+        }
+        if (target == patch)
+            return false;
+        target = patch;
+        return true;
+    }
+
+    bool isChanged = false;
+    for (const auto& item : patch.items())
+    {
+        tokens.push_back(item.key());
+        json::iterator child = target.find(item.key());
+        if (child == target.end())
+        {
+            if (!item.value().is_null())
+                throw std::runtime_error(SOURCE_LOCATION + "Adding " + joinPath(tokens) + " using PATCH is not allowed");
+        }
+        else if (item.value().is_null())
+        {
+            checkReadonly(*child, item.value(), tokens);
+            target.erase(child);
+            isChanged = true;
+        }
+        else if (patchValue(*child, item.value(), tokens))
+        {
+            isChanged = true;
+        }
+        tokens.pop_back();
+    }
+    return isChanged;
+}
+
+
+bool ConfigSchema::isUnselected(const Rule& rule, const json& config) const
+{
+    size_t optionsDepth = m_optionsTokens.size();
+    if (optionsDepth == 0 || rule.tokens.size() <= optionsDepth)
+        return false;
+    if (!std::equal(m_optionsTokens.begin(), m_optionsTokens.end(), rule.tokens.begin()))
+        return false;
+    if (!config.contains(m_selectedPointer) || !config.at(m_selectedPointer).is_string())
+        return false;
+    return rule.tokens[optionsDepth] != config.at(m_selectedPointer).get<std::string>();
+}
+
+
+void ConfigSchema::validateMatches(const Rule& rule, const json& value, std::vector<std::string>& tokens) const
+{
+    if (tokens.size() == rule.tokens.size())
+    {
+        checkRule(rule, value, tokens);
+        return;
+    }
+    if (!value.is_object())
+        return;
+
+    const std::string& ruleToken = rule.tokens[tokens.size()];
+    for (const auto& item : value.items())
+    {
+        if (ruleToken != "*" && ruleToken != item.key())
+            continue;
+        tokens.push_back(item.key());
+        validateMatches(rule, item.value(), tokens);
+        tokens.pop_back();
+    }
+}
+
+
+bool ConfigSchema::clampMatches(const Rule& rule, json& value, std::vector<std::string>& tokens) const
+{
+    if (tokens.size() == rule.tokens.size())
+    {
+        // Values of another type can not be repaired, validate() reports them
+        if (!value.is_number())
+            return false;
+        double number = value.get<double>();
+        if (number >= rule.min && number <= rule.max)
+            return false;
+        double bound = number < rule.min ? rule.min : rule.max;
+        if (rule.type == RuleType::IntegerRange)
+            value = static_cast<int64_t>(bound);
+        else
+            value = bound;
+        return true;
+    }
+    if (!value.is_object())
+        return false;
+
+    bool isChanged = false;
+    const std::string& ruleToken = rule.tokens[tokens.size()];
+    for (auto& item : value.items())
+    {
+        if (ruleToken != "*" && ruleToken != item.key())
+            continue;
+        tokens.push_back(item.key());
+        isChanged = clampMatches(rule, item.value(), tokens) || isChanged;
+        tokens.pop_back();
+    }
+    return isChanged;
+}
+
+
+void ConfigSchema::checkRule(const Rule& rule, const json& value, const std::vector<std::string>& tokens) const
+{
+    switch (rule.type)
+    {
+        case RuleType::Readonly:
+            break;
+        case RuleType::IntegerRange:
+            if (!value.is_number_integer())
+                throw std::runtime_error(SOURCE_LOCATION + joinPath(tokens) + " must be an integer, not " + value.dump());
+            // fall through
+        case RuleType::Range:
+            if (!value.is_number() || value.get<double>() < rule.min || value.get<double>() > rule.max)
+            {
+                throw std::runtime_error(
+                    SOURCE_LOCATION + joinPath(tokens) + " must be within " + formatBound(rule.min) +
+                    " and " + formatBound(rule.max) + ", not " + value.dump()
+                );
+            }
+            break;
+        case RuleType::OneOf:
+            if (std::find(rule.values.begin(), rule.values.end(), value) == rule.values.end())
+            {
+                throw std::runtime_error(
+                    SOURCE_LOCATION + joinPath(tokens) + " must be one of " + json(rule.values).dump() + ", not " + value.dump()
+                );
+            }
+            break;
+        case RuleType::Pin:
+            if (!value.is_number_integer() || std::find(rule.values.begin(), rule.values.end(), value) == rule.values.end())
+            {
+                throw std::runtime_error(
+                    SOURCE_LOCATION + joinPath(tokens) + " is set to " + value.dump() +
+                    ", which is not a usable pin. Usable pins are " + json(rule.values).dump()
+                );
+            }
+            break;
+    }
+}
+
+
+void ConfigSchema::checkReadonly(const json& target, const json& patch, const std::vector<std::string>& tokens) const
+{
+    for (const auto& rule : m_rules)
+    {
+        if (rule.type == RuleType::Readonly && isMatching(rule.tokens, tokens) && target != patch)
+            throw std::runtime_error(SOURCE_LOCATION + joinPath(tokens) + " is readonly");
+    }
+}
\ No newline at end of file
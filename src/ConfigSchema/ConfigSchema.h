@@ -0,0 +1,63 @@
+#pragma once
+
+#include <json.hpp>
+#include <string>
+#include <vector>
+
+// Declarative rules for the values of a config, addressed by JSON pointer. A "*" token matches every key
+// of an object, so a rule can apply to all entries of a map. Patching walks the patch only, checks each
+// changed value against the type of the value it replaces and the rules of its path, and changes the
+// target in place.
+class ConfigSchema
+{
+public:
+    // Values, which may only be patched with what they already are
+    ConfigSchema& readonly(const std::string& path);
+    ConfigSchema& range(const std::string& path, double min, double max);
+    ConfigSchema& integerRange(const std::string& path, int64_t min, int64_t max);
+    ConfigSchema& oneOf(const std::string& path, std::vector<json> values);
+    ConfigSchema& pin(const std::string& path, std::vector<uint8_t> pins);
+    // Of the objects below optionsPath, only the one named by the value at selectedPath is validated. The others
+    // may still hold values of an older firmware, which keep the selected one from being configured.
+    ConfigSchema& selectable(const std::string& optionsPath, const std::string& selectedPath);
+
+    // Checks all rules against a complete config
+    void validate(const json& config) const;
+    // Moves numbers, which are out of the range of their rule, to the nearest bound. Meant for configs written by
+    // an older firmware, whose ranges were wider. Returns false, if nothing changed.
+    bool clamp(json* config) const;
+    // Applies a JSON merge patch, which may not add properties. Returns false, if nothing changed.
+    // A failed patch may leave the target partially patched, so patch a copy.
+    bool patch(json* target, const json& patch) const;
+
+private:
+    enum class RuleType
+    {
+        Readonly,
+        Range,
+        IntegerRange,
+        OneOf,
+        Pin,
+    };
+
+    struct Rule
+    {
+        RuleType type;
+        std::vector<std::string> tokens;
+        double min;
+        double max;
+        std::vector<json> values;
+    };
+
+    ConfigSchema& addRule(RuleType type, const std::string& path, double min, double max, std::vector<json> values);
+    bool patchValue(json& target, const json& patch, std::vector<std::string>& tokens) const;
+    bool isUnselected(const Rule& rule, const json& config) const;
+    void validateMatches(const Rule& rule, const json& value, std::vector<std::string>& tokens) const;
+    bool clampMatches(const Rule& rule, json& value, std::vector<std::string>& tokens) const;
+    void checkRule(const Rule& rule, const json& value, const std::vector<std::string>& tokens) const;
+    void checkReadonly(const json& target, const json& patch, const std::vector<std::string>& tokens) const;
+
+    std::vector<Rule> m_rules;
+    std::vector<std::string> m_optionsTokens;
+    json::json_pointer m_selectedPointer;
+};
\ No newline at end of file
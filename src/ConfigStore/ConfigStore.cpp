@@ -0,0 +1,179 @@
+#include "ConfigStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include "Logger/Logger.h"
+
+
+ConfigStore::Section::Section(ConfigStore* store, std::string name) noexcept :
+    m_store(store),
+    m_name(std::move(name))
+{}
+
+
+json ConfigStore::Section::deserialize()
+{
+    return m_store->getSection(m_name);
+}
+
+
+void ConfigStore::Section::serialize(const json& data)
+{
+    m_store->commit({{m_name, data}});
+}
+
+
+void ConfigStore::Section::remove()
+{
+    m_store->removeSection(m_name);
+}
+
+
+uint32_t ConfigStore::Section::getGeneration() const noexcept
+{
+    return m_store->getGeneration(m_name);
+}
+
+
+ConfigStore::ConfigStore(std::unique_ptr<JsonResource> resource) noexcept :
+    m_resource(std::move(resource))
+{}
+
+
+json ConfigStore::getSection(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    load();
+    auto sectionIterator = m_document.find(name);
+    if (sectionIterator == m_document.end())
+        throw std::runtime_error(SOURCE_LOCATION + "Config section \"" + name + "\" does not exist");
+    return *sectionIterator;
+}
+
+
+bool ConfigStore::hasSection(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    load();
+    return m_document.contains(name);
+}
+
+
+void ConfigStore::commit(const json& sections)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        load();
+        json document = m_document;
+        for (const auto& section : sections.items())
+            document[section.key()] = section.value();
+        write(std::move(document));
+        for (const auto& section : sections.items())
+            m_generations[section.key()]++;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to commit " + sections.dump());
+        throw;
+    }
+}
+
+
+void ConfigStore::removeSection(const std::string& name)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        load();
+        json document = m_document;
+        document.erase(name);
+        write(std::move(document));
+        m_generations[name]++;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to remove config section \"" + name + "\"");
+        throw;
+    }
+}
+
+
+uint32_t ConfigStore::getGeneration(const std::string& name) noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto generationIterator = m_generations.find(name);
+    return generationIterator == m_generations.end() ? 0 : generationIterator->second;
+}
+
+
+void ConfigStore::import(const LegacyResources& legacyResources)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        load();
+        json document = m_document;
+        std::vector<std::string> importedNames;
+        std::vector<JsonResource*> importedResources;
+        for (const auto& legacyResource : legacyResources)
+        {
+            if (document.contains(legacyResource.first))
+                continue;
+            try
+            {
+                document[legacyResource.first] = legacyResource.second->deserialize();
+                importedNames.push_back(legacyResource.first);
+                importedResources.push_back(legacyResource.second.get());
+                Logger[LogLevel::Info] << "Imported config section \"" << legacyResource.first << "\"." << std::endl;
+            }
+            catch (...)
+            {
+                // Nothing to import, the section gets its default when it is configured
+                ExceptionTrace::clear();
+            }
+        }
+        if (importedResources.empty())
+            return;
+
+        write(std::move(document));
+        for (const std::string& importedName : importedNames)
+            m_generations[importedName]++;
+        for (JsonResource* importedResource : importedResources)
+        {
+            try
+            {
+                importedResource->remove();
+            }
+            catch (...)
+            {
+                ExceptionTrace::clear();
+            }
+        }
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to import legacy configs");
+        throw;
+    }
+}
+
+
+void ConfigStore::load()
+{
+    if (m_isLoaded)
+        return;
+    m_document = m_resource->deserializeOr(json::object());
+    if (!m_document.is_object())
+    {
+        Logger[LogLevel::Warning] << "Config store is not an object. Starting empty." << std::endl;
+        m_document = json::object();
+    }
+    m_isLoaded = true;
+}
+
+
+void ConfigStore::write(json document)
+{
+    m_resource->serialize(document);
+    m_document = std::move(document);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "JsonResource/JsonResource.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// All configs in one document, which is read once and kept in RAM. Each config is a section of it,
+// accessed through a Section, which can be used wherever a JsonResource is expected. Commits of several
+// sections are written at once, so they are either all persisted or none of them.
+class ConfigStore
+{
+public:
+    class Section : public JsonResource
+    {
+    public:
+        Section(ConfigStore* store, std::string name) noexcept;
+        json deserialize() override;
+        void serialize(const json& data) override;
+        void remove() override;
+        uint32_t getGeneration() const noexcept override;
+
+    private:
+        ConfigStore* m_store;
+        std::string m_name;
+    };
+
+    using LegacyResources = std::map<std::string, std::unique_ptr<JsonResource>>;
+
+    explicit ConfigStore(std::unique_ptr<JsonResource> resource) noexcept;
+    json getSection(const std::string& name);
+    bool hasSection(const std::string& name);
+    // Takes an object of section names and their new data
+    void commit(const json& sections);
+    void removeSection(const std::string& name);
+    // Advances whenever the section is committed, removed or imported
+    uint32_t getGeneration(const std::string& name) noexcept;
+    // Moves sections, which are not in the store yet, out of the resources they were kept in before
+    void import(const LegacyResources& legacyResources);
+
+private:
+    void load();
+    void write(json document);
+
+    std::unique_ptr<JsonResource> m_resource;
+    json m_document;
+    std::map<std::string, uint32_t> m_generations;
+    bool m_isLoaded = false;
+    std::mutex m_mutex;
+};
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "Crc32.h"
+
+namespace
+{
+    // Half byte table, small enough to not matter in flash and fast enough for a few hundred bytes
+    constexpr uint32_t nibbleTable[16] = {
+        0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+        0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+        0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+        0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+    };
+}
+
+
+uint32_t Crc32::calculate(const void* data, size_t size, uint32_t previousCrc) noexcept
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint32_t crc = ~previousCrc;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc ^= bytes[i];
+        crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+        crc = (crc >> 4) ^ nibbleTable[crc & 0x0F];
+    }
+    return ~crc;
+}
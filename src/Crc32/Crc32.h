@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Crc32
+{
+    // CRC-32 (IEEE 802.3), pass the previous result to continue over several buffers
+    uint32_t calculate(const void* data, size_t size, uint32_t previousCrc = 0) noexcept;
+}
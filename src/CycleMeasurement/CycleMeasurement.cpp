@@ -0,0 +1,13 @@
+#include "CycleMeasurement.h"
+
+
+json CycleMeasurement::toJson() const
+{
+    return {
+        {"timestamp_us", timestamp_us},
+        {"duration_us", duration_us},
+        {"voltage_V", voltage_V},
+        {"current_A", current_A},
+        {"activePower_W", activePower_W},
+    };
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "SpmcRing/SpmcRing.h"
+#include <json.hpp>
+
+
+// Result of a single mains (half) cycle, aligned on the rising (and falling) zero crossing of the voltage
+struct CycleMeasurement
+{
+    json toJson() const;
+    uint64_t timestamp_us;  // End of the cycle, counted from the start of sampling
+    uint32_t duration_us;
+    float voltage_V;
+    float current_A;
+    float activePower_W;    // Negative while exporting
+};
+
+// Holds about 2.5 s of full cycles at 50 Hz
+using CycleRing = SpmcRing<CycleMeasurement, 128>;
@@ -0,0 +1,139 @@
+#include "EnergyRegister.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include "Logger/Logger.h"
+#include <math.h>
+#include <utility>
+
+namespace
+{
+    constexpr int64_t microjoulesPerMilliwattHour = 3600000;
+}
+
+
+EnergyRegister::EnergyRegister(
+    const Clock* clock,
+    std::unique_ptr<JsonResource> storageResource,
+    time_t checkpointInterval_s
+) noexcept :
+    m_clock(clock),
+    m_storageResource(std::move(storageResource)),
+    m_checkpointInterval_s(checkpointInterval_s),
+    m_lastCheckpointTimestamp(clock->now())
+{
+    restore();
+}
+
+
+void EnergyRegister::add(const MeasurementFrame& frame) noexcept
+{
+    if (!frame.isValid())
+        return;
+
+    // W * us = uJ
+    int64_t energy_uJ = llround(static_cast<double>(frame.getSignedActivePower_W()) * frame.getDuration_us());
+    if (energy_uJ >= 0)
+        m_import.add(energy_uJ);
+    else
+        m_export.add(-energy_uJ);
+    publish();
+}
+
+
+bool EnergyRegister::checkpoint(bool force)
+{
+    try
+    {
+        time_t now = m_clock->now();
+        time_t lastCheckpointTimestamp = m_lastCheckpointTimestamp.load();
+        // The clock has been set back
+        if (now < lastCheckpointTimestamp)
+            lastCheckpointTimestamp = now;
+
+        if (!force && now - lastCheckpointTimestamp < m_checkpointInterval_s)
+        {
+            m_lastCheckpointTimestamp = lastCheckpointTimestamp;
+            return false;
+        }
+
+        m_lastCheckpointTimestamp = now;
+        Counters counters = m_counters.load();
+        if (counters.imported.energy_mWh == m_checkpointedImport_mWh && counters.exported.energy_mWh == m_checkpointedExport_mWh)
+            return false;
+
+        m_storageResource->serialize({
+            {"import_mWh", counters.imported.energy_mWh},
+            {"export_mWh", counters.exported.energy_mWh},
+        });
+        m_checkpointedImport_mWh = counters.imported.energy_mWh;
+        m_checkpointedExport_mWh = counters.exported.energy_mWh;
+        return true;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to checkpoint EnergyRegister");
+        throw;
+    }
+}
+
+
+double EnergyRegister::getImport_Wh() const noexcept
+{
+    return m_counters.load().imported.getEnergy_Wh();
+}
+
+
+double EnergyRegister::getExport_Wh() const noexcept
+{
+    return m_counters.load().exported.getEnergy_Wh();
+}
+
+
+json EnergyRegister::toJson() const
+{
+    Counters counters = m_counters.load();
+    return {
+        {"import_Wh", counters.imported.getEnergy_Wh()},
+        {"export_Wh", counters.exported.getEnergy_Wh()},
+        {"lastCheckpointTimestamp", m_lastCheckpointTimestamp.load()},
+    };
+}
+
+
+void EnergyRegister::publish() noexcept
+{
+    m_counters.store(Counters{m_import, m_export});
+}
+
+
+void EnergyRegister::Counter::add(int64_t energy_uJ) noexcept
+{
+    remainder_uJ += energy_uJ;
+    energy_mWh += remainder_uJ / microjoulesPerMilliwattHour;
+    remainder_uJ %= microjoulesPerMilliwattHour;
+}
+
+
+double EnergyRegister::Counter::getEnergy_Wh() const noexcept
+{
+    return (energy_mWh + static_cast<double>(remainder_uJ) / microjoulesPerMilliwattHour) / 1000.0;
+}
+
+
+void EnergyRegister::restore() noexcept
+{
+    try
+    {
+        json data = m_storageResource->deserialize();
+        m_import.energy_mWh = data.at("import_mWh");
+        m_export.energy_mWh = data.at("export_mWh");
+        m_checkpointedImport_mWh = m_import.energy_mWh;
+        m_checkpointedExport_mWh = m_export.energy_mWh;
+        publish();
+    }
+    catch (...)
+    {
+        ExceptionTrace::clear();
+        Logger[LogLevel::Warning] << "No stored energy counters found, starting at 0 Wh" << std::endl;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Clock/Clock.h"
+#include "MeasurementFrame/MeasurementFrame.h"
+#include "JsonResource/JsonResource.h"
+#include "Rtos/SeqLock/SeqLock.h"
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+// Integrates the active power of every measuring window into monotonic import and export counters. Windows
+// cover every sample the measuring unit processed, including cycles too long to be published to the CycleRing,
+// so no energy is lost between them. Import and export are netted within a window.
+// The counters are kept in RAM and written to the storage resource at most once per checkpoint interval,
+// so a power loss costs at most the energy of one interval.
+// add() must only be called by the measuring task. They publish the counters through a seqlock,
+// so checkpoint() and the getters never hold up the measuring task, not even while the checkpoint is written to flash.
+class EnergyRegister
+{
+public:
+    EnergyRegister(
+        const Clock* clock,
+        std::unique_ptr<JsonResource> storageResource,
+        time_t checkpointInterval_s
+    ) noexcept;
+    // Frames without values, e.g. of a failed measurement, are skipped
+    void add(const MeasurementFrame& frame) noexcept;
+    bool checkpoint(bool force = false);
+    double getImport_Wh() const noexcept;
+    double getExport_Wh() const noexcept;
+    json toJson() const;
+
+private:
+    struct Counter
+    {
+        void add(int64_t energy_uJ) noexcept;
+        double getEnergy_Wh() const noexcept;
+        uint64_t energy_mWh = 0;
+        int64_t remainder_uJ = 0;
+    };
+
+    struct Counters
+    {
+        Counter imported;
+        Counter exported;
+    };
+
+    void publish() noexcept;
+    void restore() noexcept;
+
+    const Clock* m_clock;
+    std::unique_ptr<JsonResource> m_storageResource;
+    time_t m_checkpointInterval_s;
+    std::atomic<time_t> m_lastCheckpointTimestamp;
+    // Only touched by the measuring task
+    Counter m_import;
+    Counter m_export;
+    Rtos::SeqLock<Counters> m_counters;
+    // Only touched by the task writing the checkpoints
+    uint64_t m_checkpointedImport_mWh = 0;
+    uint64_t m_checkpointedExport_mWh = 0;
+};
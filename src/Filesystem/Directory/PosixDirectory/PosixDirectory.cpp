@@ -0,0 +1,107 @@
+#ifndef ESP32
+
+#include "PosixDirectory.h"
+#include "Filesystem/File/PosixFile/PosixFile.h"
+#include "SourceLocation/SourceLocation.h"
+#include <unique_resource.hpp>
+#include <dirent.h>
+#include <errno.h>
+#include <sstream>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Filesystem;
+
+
+namespace
+{
+    bool compareEntries(const std::unique_ptr<Entry>& lhs, const std::unique_ptr<Entry>& rhs)
+    {
+        return lhs->getPath() < rhs->getPath();
+    }
+}
+
+
+PosixDirectory::PosixDirectory(std::string path) noexcept : m_path(std::move(path))
+{}
+
+
+Directory::Entries PosixDirectory::getEntries() const
+{
+    DIR* rawDirectory = opendir(m_path.c_str());
+    if (!rawDirectory)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open directory at \"" + m_path + '"');
+
+    auto directory = std_experimental::unique_resource<DIR*, int(*)(DIR*)>(
+        std::move(rawDirectory),
+        closedir
+    );
+
+    struct dirent* directoryEntry;
+    Entries entries(compareEntries);
+    while ((directoryEntry = readdir(directory)))
+    {
+        if (strcmp(directoryEntry->d_name, ".") == 0 || strcmp(directoryEntry->d_name, "..") == 0)
+            continue;
+
+        std::string entryPath = (m_path == "/" ? "" : m_path) + '/' + directoryEntry->d_name;
+        // d_type is not filled in by every filesystem
+        struct stat status;
+        if (stat(entryPath.c_str(), &status) == 0 && S_ISDIR(status.st_mode))
+            entries.emplace(new PosixDirectory(entryPath));
+        else
+            entries.emplace(new PosixFile(entryPath));
+    }
+    return entries;
+}
+
+
+std::string PosixDirectory::getPath() const
+{
+    return m_path;
+}
+
+
+std::string PosixDirectory::getName() const
+{
+    return m_path.substr(m_path.rfind('/') + 1);
+}
+
+
+bool PosixDirectory::exists() const
+{
+    struct stat status;
+    return stat(m_path.c_str(), &status) == 0 && S_ISDIR(status.st_mode);
+}
+
+
+void PosixDirectory::create()
+{
+    std::istringstream pathStream(m_path);
+    std::string token;
+    std::string currentPath;
+    bool isAbsolute = !m_path.empty() && m_path.front() == '/';
+    while (std::getline(pathStream, token, '/'))
+    {
+        if (!token.empty())
+        {
+            if (isAbsolute || !currentPath.empty())
+                currentPath += '/';
+            currentPath += token;
+            if (mkdir(currentPath.c_str(), 0755) != 0 && errno != EEXIST)
+                throw std::runtime_error(SOURCE_LOCATION + "Failed to create directory at \"" + m_path + '"');
+        }
+    }
+}
+
+
+void PosixDirectory::remove()
+{
+    for (const auto& entry : getEntries())
+        entry->remove();
+    if (rmdir(m_path.c_str()) != 0)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to remove directory at \"" + m_path + '"');
+}
+
+#endif
\ No newline at end of file
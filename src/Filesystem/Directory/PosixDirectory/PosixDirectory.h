@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Filesystem/Directory/Directory.h"
+
+namespace Filesystem
+{
+    class PosixDirectory : public Directory
+    {
+    public:
+        explicit PosixDirectory(std::string path) noexcept;
+        Entries getEntries() const override;
+        std::string getPath() const override;
+        std::string getName() const override;
+        bool exists() const override;
+        void create() override;
+        void remove() override;
+
+    private:
+        std::string m_path;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "RamDirectory.h"
+#include "Filesystem/File/RamFile/RamFile.h"
+#include "SourceLocation/SourceLocation.h"
+
+using namespace Filesystem;
+
+
+namespace
+{
+    bool compareEntries(const std::unique_ptr<Entry>& lhs, const std::unique_ptr<Entry>& rhs)
+    {
+        return lhs->getPath() < rhs->getPath();
+    }
+}
+
+
+RamDirectory::RamDirectory(std::string path, std::shared_ptr<RamStorage> storage) noexcept :
+    m_path(std::move(path)),
+    m_storage(std::move(storage))
+{}
+
+
+Directory::Entries RamDirectory::getEntries() const
+{
+    if (!exists())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open directory at \"" + m_path + '"');
+
+    Entries entries(compareEntries);
+    for (const auto& child : m_storage->getChildren(m_path))
+    {
+        std::string entryPath = (m_path == "/" ? "" : m_path) + '/' + child.name;
+        if (child.isDirectory)
+            entries.emplace(new RamDirectory(entryPath, m_storage));
+        else
+            entries.emplace(new RamFile(entryPath, m_storage));
+    }
+    return entries;
+}
+
+
+std::string RamDirectory::getPath() const
+{
+    return m_path;
+}
+
+
+std::string RamDirectory::getName() const
+{
+    return m_path.substr(m_path.rfind('/') + 1);
+}
+
+
+bool RamDirectory::exists() const
+{
+    return m_storage->isDirectory(m_path);
+}
+
+
+void RamDirectory::create()
+{
+    if (m_storage->isFile(m_path))
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to create directory at \"" + m_path + '"');
+    m_storage->createDirectory(m_path);
+}
+
+
+void RamDirectory::remove()
+{
+    for (const auto& entry : getEntries())
+        entry->remove();
+    m_storage->removeDirectory(m_path);
+    if (exists())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to remove directory at \"" + m_path + '"');
+}
\ No newline at end of file
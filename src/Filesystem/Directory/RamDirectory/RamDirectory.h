@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Filesystem/Directory/Directory.h"
+#include "Filesystem/RamStorage/RamStorage.h"
+#include <memory>
+
+namespace Filesystem
+{
+    class RamDirectory : public Directory
+    {
+    public:
+        RamDirectory(std::string path, std::shared_ptr<RamStorage> storage) noexcept;
+        Entries getEntries() const override;
+        std::string getPath() const override;
+        std::string getName() const override;
+        bool exists() const override;
+        void create() override;
+        void remove() override;
+
+    private:
+        std::string m_path;
+        std::shared_ptr<RamStorage> m_storage;
+    };
+}
\ No newline at end of file
@@ -4,9 +4,15 @@
 #include "SourceLocation/SourceLocation.h"
 #include "Logger/Logger.h"
 #include <LittleFS.h>
+#include <atomic>
 
 using namespace Filesystem;
 
+namespace
+{
+    std::atomic<uint32_t> writeCount(0);
+}
+
 LittleFsFile::LittleFsFile(std::string path) : m_path(std::move(path))
 {}
 
@@ -25,8 +31,12 @@ std::string Filesystem::LittleFsFile::getName() const
 
 Filesystem::File::Stream LittleFsFile::open(std::ios::openmode mode)
 {
-    if ((mode & std::ios::out) && !exists())
-        create();
+    if (mode & std::ios::out)
+    {
+        writeCount++;
+        if (!exists())
+            create();
+    }
 
     m_fileStream.open(m_path, mode);
     if (!m_fileStream.good())
@@ -58,6 +68,12 @@ bool LittleFsFile::exists() const
 }
 
 
+uint32_t LittleFsFile::getWriteCount() noexcept
+{
+    return writeCount;
+}
+
+
 void LittleFsFile::remove()
 {
     if (!LittleFS.remove(m_path.c_str()))
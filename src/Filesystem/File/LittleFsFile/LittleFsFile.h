@@ -19,6 +19,8 @@ namespace Filesystem
         void create() override;
         bool exists() const override;
         void remove() override;
+        // Number of times any file has been opened for writing since boot
+        static uint32_t getWriteCount() noexcept;
 
     private:
         std::string m_path;
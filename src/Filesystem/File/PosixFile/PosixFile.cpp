@@ -0,0 +1,77 @@
+#ifndef ESP32
+
+#include "PosixFile.h"
+#include "Filesystem/Directory/PosixDirectory/PosixDirectory.h"
+#include "SourceLocation/SourceLocation.h"
+#include <stdio.h>
+#include <sys/stat.h>
+
+using namespace Filesystem;
+
+
+PosixFile::PosixFile(std::string path) noexcept : m_path(std::move(path))
+{}
+
+
+std::string PosixFile::getPath() const
+{
+    return m_path;
+}
+
+
+std::string PosixFile::getName() const
+{
+    return m_path.substr(m_path.rfind('/') + 1);
+}
+
+
+File::Stream PosixFile::open(std::ios::openmode mode)
+{
+    if ((mode & std::ios::out) && !exists())
+        create();
+
+    m_fileStream.open(m_path, mode);
+    if (!m_fileStream.good())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open file at \"" + m_path + '"');
+    return File::Stream(&m_fileStream, [this](std::iostream*){
+        m_fileStream.close();
+    });
+}
+
+
+time_t PosixFile::getLastWriteTimestamp() const
+{
+    struct stat status;
+    if (stat(m_path.c_str(), &status) != 0)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open file at \"" + m_path + '"');
+    return status.st_mtime;
+}
+
+
+void PosixFile::create()
+{
+    // Creates missing parent directories like LittleFS does
+    size_t separatorPosition = m_path.rfind('/');
+    if (separatorPosition != std::string::npos && separatorPosition > 0)
+        PosixDirectory(m_path.substr(0, separatorPosition)).create();
+
+    std::ofstream fileStream(m_path, std::ios::app);
+    if (!fileStream.good())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to create file at \"" + m_path + '"');
+}
+
+
+bool PosixFile::exists() const
+{
+    struct stat status;
+    return stat(m_path.c_str(), &status) == 0 && S_ISREG(status.st_mode);
+}
+
+
+void PosixFile::remove()
+{
+    if (::remove(m_path.c_str()) != 0)
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to remove file at \"" + m_path + '"');
+}
+
+#endif
\ No newline at end of file
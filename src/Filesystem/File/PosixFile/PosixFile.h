@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Filesystem/File/File.h"
+#include <fstream>
+#include <string>
+
+namespace Filesystem
+{
+    // File of the host filesystem, lets the storage code run its real I/O paths in the pc environment
+    class PosixFile : public File
+    {
+    public:
+        explicit PosixFile(std::string path) noexcept;
+        std::string getPath() const override;
+        std::string getName() const override;
+        Stream open(std::ios::openmode mode) override;
+        time_t getLastWriteTimestamp() const override;
+        void create() override;
+        bool exists() const override;
+        void remove() override;
+
+    private:
+        std::string m_path;
+        std::fstream m_fileStream;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "RamFile.h"
+#include "SourceLocation/SourceLocation.h"
+
+using namespace Filesystem;
+
+
+RamFile::RamFile(std::string path, std::shared_ptr<RamStorage> storage) noexcept :
+    m_path(std::move(path)),
+    m_storage(std::move(storage))
+{}
+
+
+std::string RamFile::getPath() const
+{
+    return m_path;
+}
+
+
+std::string RamFile::getName() const
+{
+    return m_path.substr(m_path.rfind('/') + 1);
+}
+
+
+File::Stream RamFile::open(std::ios::openmode mode)
+{
+    tl::optional<RamStorage::FileData> file = m_storage->readFile(m_path);
+    if (!file.has_value() && !(mode & std::ios::out))
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open file at \"" + m_path + '"');
+
+    // Same semantics as std::fstream: only in | out without trunc keeps the content for writing
+    bool truncate = (mode & std::ios::out) && (!(mode & std::ios::in) || (mode & std::ios::trunc));
+    m_stream.str(file.has_value() && !truncate ? file->content : "");
+    m_stream.clear();
+    m_stream.seekg(0);
+    if (mode & (std::ios::app | std::ios::ate))
+        m_stream.seekp(0, std::ios::end);
+    else
+        m_stream.seekp(0);
+
+    if (!(mode & std::ios::out))
+        return File::Stream(&m_stream, [](std::iostream*){});
+    return File::Stream(&m_stream, [this](std::iostream*){
+        m_storage->writeFile(m_path, m_stream.str());
+    });
+}
+
+
+time_t RamFile::getLastWriteTimestamp() const
+{
+    tl::optional<RamStorage::FileData> file = m_storage->readFile(m_path);
+    if (!file.has_value())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to open file at \"" + m_path + '"');
+    return file->lastWriteTimestamp;
+}
+
+
+void RamFile::create()
+{
+    if (!exists())
+        m_storage->writeFile(m_path, "");
+}
+
+
+bool RamFile::exists() const
+{
+    return m_storage->isFile(m_path);
+}
+
+
+void RamFile::remove()
+{
+    if (!m_storage->removeFile(m_path))
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to remove file at \"" + m_path + '"');
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Filesystem/File/File.h"
+#include "Filesystem/RamStorage/RamStorage.h"
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace Filesystem
+{
+    // File of a RamStorage. Content written through a stream becomes visible when the stream is closed.
+    class RamFile : public File
+    {
+    public:
+        RamFile(std::string path, std::shared_ptr<RamStorage> storage) noexcept;
+        std::string getPath() const override;
+        std::string getName() const override;
+        Stream open(std::ios::openmode mode) override;
+        time_t getLastWriteTimestamp() const override;
+        void create() override;
+        bool exists() const override;
+        void remove() override;
+
+    private:
+        std::string m_path;
+        std::shared_ptr<RamStorage> m_storage;
+        std::stringstream m_stream;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "RamStorage.h"
+
+using namespace Filesystem;
+
+namespace
+{
+    std::string getPrefix(const std::string& path)
+    {
+        return path == "/" ? path : path + '/';
+    }
+
+
+    bool startsWith(const std::string& string, const std::string& prefix)
+    {
+        return string.compare(0, prefix.size(), prefix) == 0;
+    }
+}
+
+
+tl::optional<RamStorage::FileData> RamStorage::readFile(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto fileIterator = m_files.find(path);
+    if (fileIterator == m_files.end())
+        return tl::nullopt;
+    return fileIterator->second;
+}
+
+
+void RamStorage::writeFile(const std::string& path, std::string content)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_writeCount++;
+    m_writtenSize_B += content.size();
+    FileData& file = m_files[path];
+    file.content = std::move(content);
+    file.lastWriteTimestamp = std::time(nullptr);
+}
+
+
+bool RamStorage::removeFile(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_files.erase(path) > 0;
+}
+
+
+bool RamStorage::isFile(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_files.count(path) > 0;
+}
+
+
+bool RamStorage::isDirectory(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return path == "/" || m_directories.count(path) > 0 || hasChildren(path);
+}
+
+
+void RamStorage::createDirectory(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_directories.insert(path);
+}
+
+
+bool RamStorage::removeDirectory(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (hasChildren(path))
+        return false;
+    return m_directories.erase(path) > 0;
+}
+
+
+std::vector<RamStorage::Child> RamStorage::getChildren(const std::string& path) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::string prefix = getPrefix(path);
+    std::map<std::string, bool> children;
+    auto addChild = [&](const std::string& descendantPath, bool isDirectory){
+        if (!startsWith(descendantPath, prefix) || descendantPath.size() == prefix.size())
+            return;
+        size_t separatorPosition = descendantPath.find('/', prefix.size());
+        std::string name = descendantPath.substr(prefix.size(), separatorPosition - prefix.size());
+        children[name] = children[name] || isDirectory || separatorPosition != std::string::npos;
+    };
+
+    for (const auto& file : m_files)
+        addChild(file.first, false);
+    for (const auto& directory : m_directories)
+        addChild(directory, true);
+
+    std::vector<Child> childList;
+    for (const auto& child : children)
+        childList.push_back({child.first, child.second});
+    return childList;
+}
+
+
+uint32_t RamStorage::getWriteCount() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writeCount;
+}
+
+
+size_t RamStorage::getWrittenSize_B() const noexcept
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_writtenSize_B;
+}
+
+
+bool RamStorage::hasChildren(const std::string& path) const
+{
+    std::string prefix = getPrefix(path);
+    auto fileIterator = m_files.lower_bound(prefix);
+    if (fileIterator != m_files.end() && startsWith(fileIterator->first, prefix))
+        return true;
+    auto directoryIterator = m_directories.upper_bound(prefix);
+    return directoryIterator != m_directories.end() && startsWith(*directoryIterator, prefix);
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <tl/optional.hpp>
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace Filesystem
+{
+    // Content of a filesystem held in RAM, shared by all RamFiles and RamDirectories created on it.
+    // Parent directories of a file exist implicitly, like on LittleFS.
+    class RamStorage
+    {
+    public:
+        struct FileData
+        {
+            std::string content;
+            time_t lastWriteTimestamp;
+        };
+
+        struct Child
+        {
+            std::string name;
+            bool isDirectory;
+        };
+
+        tl::optional<FileData> readFile(const std::string& path) const;
+        void writeFile(const std::string& path, std::string content);
+        bool removeFile(const std::string& path);
+        bool isFile(const std::string& path) const;
+        bool isDirectory(const std::string& path) const;
+        void createDirectory(const std::string& path);
+        bool removeDirectory(const std::string& path);
+        std::vector<Child> getChildren(const std::string& path) const;
+        // Number of files written and bytes written to them, to compare the flash wear of storage code paths
+        uint32_t getWriteCount() const noexcept;
+        size_t getWrittenSize_B() const noexcept;
+
+    private:
+        bool hasChildren(const std::string& path) const;
+
+        mutable std::mutex m_mutex;
+        std::map<std::string, FileData> m_files;
+        std::set<std::string> m_directories;
+        uint32_t m_writeCount = 0;
+        size_t m_writtenSize_B = 0;
+    };
+}
\ No newline at end of file
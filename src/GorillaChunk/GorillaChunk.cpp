@@ -0,0 +1,340 @@
+#include "GorillaChunk.h"
+#include <string.h>
+
+namespace
+{
+    // Worst case size of any point after the first one: 4 + 32 bits timestamp, 2 + 5 + 5 + 32 bits value
+    constexpr size_t maxPointBitCount = 80;
+    constexpr size_t firstPointBitCount = 96;
+    constexpr uint8_t noWindow = 0xFF;
+
+
+    uint32_t getFloatBits(float value) noexcept
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+
+    float getFloat(uint32_t bits) noexcept
+    {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+}
+
+
+GorillaChunk::GorillaChunk() noexcept
+{
+    clear();
+}
+
+
+bool GorillaChunk::append(const Point& point) noexcept
+{
+    if (m_count == 0)
+    {
+        writeBits(static_cast<uint64_t>(point.timestamp) >> 32, 32);
+        writeBits(static_cast<uint64_t>(point.timestamp), 32);
+        writeBits(getFloatBits(point.value), 32);
+        m_firstTimestamp = point.timestamp;
+        m_timestamp = point.timestamp;
+        m_delta = 0;
+        m_valueBits = getFloatBits(point.value);
+        m_count++;
+        return true;
+    }
+
+    int64_t deltaOfDelta = (point.timestamp - m_timestamp) - m_delta;
+    if (
+        point.timestamp <= m_timestamp ||
+        deltaOfDelta < INT32_MIN ||
+        deltaOfDelta > INT32_MAX ||
+        m_bitCount + maxPointBitCount > capacity_B * 8
+    )
+        return false;
+
+    writeTimestamp(point.timestamp);
+    writeValue(point.value);
+    m_count++;
+    return true;
+}
+
+
+bool GorillaChunk::load(const uint8_t* data, size_t bitCount, size_t count) noexcept
+{
+    clear();
+    if (bitCount > capacity_B * 8 || (count == 0) != (bitCount == 0))
+        return false;
+
+    memcpy(m_data, data, (bitCount + 7) / 8);
+    // Bits behind the end have to be zero, because writing only sets bits
+    if (bitCount % 8 != 0)
+        m_data[bitCount / 8] &= 0xFF << (8 - bitCount % 8);
+    m_bitCount = bitCount;
+    m_count = count;
+
+    Reader reader(*this);
+    Point point;
+    size_t readCount = 0;
+    while (reader.next(point))
+    {
+        if (readCount == 0)
+            m_firstTimestamp = point.timestamp;
+        readCount++;
+    }
+
+    if (readCount != count || reader.m_bitPosition != bitCount)
+    {
+        clear();
+        return false;
+    }
+
+    m_timestamp = reader.m_timestamp;
+    m_delta = reader.m_delta;
+    m_valueBits = reader.m_valueBits;
+    m_leadingZeros = reader.m_leadingZeros;
+    m_trailingZeros = reader.m_trailingZeros;
+    return true;
+}
+
+
+void GorillaChunk::clear() noexcept
+{
+    memset(m_data, 0, sizeof(m_data));
+    m_bitCount = 0;
+    m_count = 0;
+    m_firstTimestamp = 0;
+    m_timestamp = 0;
+    m_delta = 0;
+    m_valueBits = 0;
+    m_leadingZeros = noWindow;
+    m_trailingZeros = 0;
+}
+
+
+std::vector<GorillaChunk::Point> GorillaChunk::decode() const
+{
+    std::vector<Point> points;
+    points.reserve(m_count);
+    Reader reader(*this);
+    Point point;
+    while (reader.next(point))
+        points.push_back(point);
+    return points;
+}
+
+
+const uint8_t* GorillaChunk::getData() const noexcept
+{
+    return m_data;
+}
+
+
+size_t GorillaChunk::getSize_B() const noexcept
+{
+    return (m_bitCount + 7) / 8;
+}
+
+
+size_t GorillaChunk::getBitCount() const noexcept
+{
+    return m_bitCount;
+}
+
+
+size_t GorillaChunk::getCount() const noexcept
+{
+    return m_count;
+}
+
+
+int64_t GorillaChunk::getFirstTimestamp() const noexcept
+{
+    return m_firstTimestamp;
+}
+
+
+int64_t GorillaChunk::getLastTimestamp() const noexcept
+{
+    return m_timestamp;
+}
+
+
+bool GorillaChunk::isEmpty() const noexcept
+{
+    return m_count == 0;
+}
+
+
+void GorillaChunk::writeBits(uint32_t bits, uint8_t bitCount) noexcept
+{
+    while (bitCount > 0)
+    {
+        uint8_t freeBitCount = 8 - m_bitCount % 8;
+        uint8_t writeCount = bitCount < freeBitCount ? bitCount : freeBitCount;
+        uint8_t chunk = (bits >> (bitCount - writeCount)) & ((1u << writeCount) - 1);
+        m_data[m_bitCount / 8] |= chunk << (freeBitCount - writeCount);
+        m_bitCount += writeCount;
+        bitCount -= writeCount;
+    }
+}
+
+
+void GorillaChunk::writeTimestamp(int64_t timestamp) noexcept
+{
+    int64_t delta = timestamp - m_timestamp;
+    int32_t deltaOfDelta = delta - m_delta;
+
+    if (deltaOfDelta == 0)
+    {
+        writeBits(0b0, 1);
+    }
+    else if (deltaOfDelta >= -63 && deltaOfDelta <= 64)
+    {
+        writeBits(0b10, 2);
+        writeBits(deltaOfDelta + 63, 7);
+    }
+    else if (deltaOfDelta >= -255 && deltaOfDelta <= 256)
+    {
+        writeBits(0b110, 3);
+        writeBits(deltaOfDelta + 255, 9);
+    }
+    else if (deltaOfDelta >= -2047 && deltaOfDelta <= 2048)
+    {
+        writeBits(0b1110, 4);
+        writeBits(deltaOfDelta + 2047, 12);
+    }
+    else
+    {
+        writeBits(0b1111, 4);
+        writeBits(static_cast<uint32_t>(deltaOfDelta), 32);
+    }
+
+    m_timestamp = timestamp;
+    m_delta = delta;
+}
+
+
+void GorillaChunk::writeValue(float value) noexcept
+{
+    uint32_t valueBits = getFloatBits(value);
+    uint32_t xorBits = valueBits ^ m_valueBits;
+    m_valueBits = valueBits;
+
+    if (xorBits == 0)
+    {
+        writeBits(0b0, 1);
+        return;
+    }
+
+    uint8_t leadingZeros = __builtin_clz(xorBits);
+    uint8_t trailingZeros = __builtin_ctz(xorBits);
+    if (m_leadingZeros != noWindow && leadingZeros >= m_leadingZeros && trailingZeros >= m_trailingZeros)
+    {
+        // The meaningful bits fit into the window of the previous value
+        writeBits(0b10, 2);
+        writeBits(xorBits >> m_trailingZeros, 32 - m_leadingZeros - m_trailingZeros);
+        return;
+    }
+
+    uint8_t meaningfulBitCount = 32 - leadingZeros - trailingZeros;
+    writeBits(0b11, 2);
+    writeBits(leadingZeros, 5);
+    writeBits(meaningfulBitCount - 1, 5);
+    writeBits(xorBits >> trailingZeros, meaningfulBitCount);
+    m_leadingZeros = leadingZeros;
+    m_trailingZeros = trailingZeros;
+}
+
+
+GorillaChunk::Reader::Reader(const GorillaChunk& chunk) noexcept :
+    m_chunk(chunk),
+    m_leadingZeros(noWindow)
+{}
+
+
+bool GorillaChunk::Reader::next(Point& point) noexcept
+{
+    if (m_index >= m_chunk.m_count || m_bitPosition > m_chunk.m_bitCount)
+        return false;
+
+    if (m_index == 0)
+    {
+        uint64_t timestamp = static_cast<uint64_t>(readBits(32)) << 32;
+        timestamp |= readBits(32);
+        m_timestamp = timestamp;
+        m_valueBits = readBits(32);
+    }
+    else
+    {
+        int64_t deltaOfDelta;
+        if (readBits(1) == 0)
+            deltaOfDelta = 0;
+        else if (readBits(1) == 0)
+            deltaOfDelta = static_cast<int64_t>(readBits(7)) - 63;
+        else if (readBits(1) == 0)
+            deltaOfDelta = static_cast<int64_t>(readBits(9)) - 255;
+        else if (readBits(1) == 0)
+            deltaOfDelta = static_cast<int64_t>(readBits(12)) - 2047;
+        else
+            deltaOfDelta = static_cast<int32_t>(readBits(32));
+        m_delta += deltaOfDelta;
+        m_timestamp += m_delta;
+
+        if (readBits(1) == 1)
+        {
+            if (readBits(1) == 1)
+            {
+                m_leadingZeros = readBits(5);
+                uint8_t meaningfulBitCount = readBits(5) + 1;
+                if (m_leadingZeros + meaningfulBitCount > 32)
+                {
+                    m_bitPosition = SIZE_MAX;
+                    return false;
+                }
+                m_trailingZeros = 32 - m_leadingZeros - meaningfulBitCount;
+            }
+            else if (m_leadingZeros == noWindow)
+            {
+                m_bitPosition = SIZE_MAX;
+                return false;
+            }
+            uint8_t meaningfulBitCount = 32 - m_leadingZeros - m_trailingZeros;
+            m_valueBits ^= readBits(meaningfulBitCount) << m_trailingZeros;
+        }
+    }
+
+    if (m_bitPosition > m_chunk.m_bitCount)
+        return false;
+
+    point.timestamp = m_timestamp;
+    point.value = getFloat(m_valueBits);
+    m_index++;
+    return true;
+}
+
+
+uint32_t GorillaChunk::Reader::readBits(uint8_t bitCount) noexcept
+{
+    if (m_bitPosition > m_chunk.m_bitCount || bitCount > m_chunk.m_bitCount - m_bitPosition)
+    {
+        // Reading behind the end marks the reader as failed
+        m_bitPosition = SIZE_MAX;
+        return 0;
+    }
+
+    uint32_t bits = 0;
+    while (bitCount > 0)
+    {
+        uint8_t availableBitCount = 8 - m_bitPosition % 8;
+        uint8_t readCount = bitCount < availableBitCount ? bitCount : availableBitCount;
+        uint8_t byte = m_chunk.m_data[m_bitPosition / 8];
+        bits = (bits << readCount) | ((byte >> (availableBitCount - readCount)) & ((1u << readCount) - 1));
+        m_bitPosition += readCount;
+        bitCount -= readCount;
+    }
+    return bits;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+// Fixed size block of a compressed time series as described in the Gorilla paper (Pelkonen et al., VLDB 2015):
+// timestamps are stored as delta of deltas and float values as XOR with the previous value, both bit packed.
+// A chunk only accepts strictly increasing timestamps and refuses points once it might run out of space.
+class GorillaChunk
+{
+public:
+    static constexpr size_t capacity_B = 4060;
+
+    struct Point
+    {
+        int64_t timestamp;
+        float value;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(const GorillaChunk& chunk) noexcept;
+        bool next(Point& point) noexcept;
+
+    private:
+        friend class GorillaChunk;
+        uint32_t readBits(uint8_t bitCount) noexcept;
+
+        const GorillaChunk& m_chunk;
+        size_t m_bitPosition = 0;
+        size_t m_index = 0;
+        int64_t m_timestamp = 0;
+        int64_t m_delta = 0;
+        uint32_t m_valueBits = 0;
+        uint8_t m_leadingZeros = 0;
+        uint8_t m_trailingZeros = 0;
+    };
+
+    GorillaChunk() noexcept;
+    bool append(const Point& point) noexcept;
+    // Restores a chunk written before, including the state needed to append to it
+    bool load(const uint8_t* data, size_t bitCount, size_t count) noexcept;
+    void clear() noexcept;
+    std::vector<Point> decode() const;
+    const uint8_t* getData() const noexcept;
+    size_t getSize_B() const noexcept;
+    size_t getBitCount() const noexcept;
+    size_t getCount() const noexcept;
+    int64_t getFirstTimestamp() const noexcept;
+    int64_t getLastTimestamp() const noexcept;
+    bool isEmpty() const noexcept;
+
+private:
+    void writeBits(uint32_t bits, uint8_t bitCount) noexcept;
+    void writeTimestamp(int64_t timestamp) noexcept;
+    void writeValue(float value) noexcept;
+
+    uint8_t m_data[capacity_B];
+    size_t m_bitCount;
+    size_t m_count;
+    int64_t m_firstTimestamp;
+    int64_t m_timestamp;
+    int64_t m_delta;
+    uint32_t m_valueBits;
+    uint8_t m_leadingZeros;
+    uint8_t m_trailingZeros;
+};
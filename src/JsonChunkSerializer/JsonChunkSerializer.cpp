@@ -0,0 +1,100 @@
+#include "JsonChunkSerializer.h"
+#include <string.h>
+#include <algorithm>
+
+
+JsonChunkSerializer::JsonChunkSerializer(std::shared_ptr<const json> data, int indent, char indentCharacter) :
+    m_data(std::move(data)),
+    m_indent(indent),
+    m_indentCharacter(indentCharacter),
+    m_serializer(std::make_shared<nlohmann::detail::output_string_adapter<char>>(m_pending), indentCharacter)
+{}
+
+
+size_t JsonChunkSerializer::read(char* buffer, size_t maxSize)
+{
+    size_t size = 0;
+    while (size < maxSize)
+    {
+        if (m_pendingPosition == m_pending.size())
+        {
+            m_pending.clear();
+            m_pendingPosition = 0;
+            if (!advance())
+                break;
+        }
+        size_t count = std::min(maxSize - size, m_pending.size() - m_pendingPosition);
+        memcpy(buffer + size, m_pending.data() + m_pendingPosition, count);
+        m_pendingPosition += count;
+        size += count;
+    }
+    return size;
+}
+
+
+bool JsonChunkSerializer::advance()
+{
+    if (!m_isStarted)
+    {
+        m_isStarted = true;
+        writeValue(*m_data);
+        return true;
+    }
+    if (m_stack.empty())
+        return false;
+
+    Frame& frame = m_stack.back();
+    bool isObject = frame.container->is_object();
+    if (frame.position == frame.container->cend())
+    {
+        m_stack.pop_back();
+        if (m_indent >= 0)
+        {
+            m_pending += '\n';
+            writeIndent(m_stack.size());
+        }
+        m_pending += isObject ? '}' : ']';
+        return true;
+    }
+
+    if (frame.position != frame.container->cbegin())
+        m_pending += ',';
+    if (m_indent >= 0)
+    {
+        m_pending += '\n';
+        writeIndent(m_stack.size());
+    }
+    if (isObject)
+    {
+        // Reuses the string of m_key instead of allocating one per key
+        m_key.get_ref<std::string&>() = frame.position.key();
+        m_serializer.dump(m_key, false, false, 0);
+        m_pending += m_indent >= 0 ? ": " : ":";
+    }
+    // The frame is invalid after writeValue() pushed a new one
+    const json& value = *frame.position;
+    ++frame.position;
+    writeValue(value);
+    return true;
+}
+
+
+void JsonChunkSerializer::writeValue(const json& value)
+{
+    if (!value.is_structured())
+    {
+        m_serializer.dump(value, false, false, 0);
+        return;
+    }
+    m_pending += value.is_object() ? '{' : '[';
+    if (value.empty())
+        m_pending += value.is_object() ? '}' : ']';
+    else
+        m_stack.push_back(Frame{&value, value.cbegin()});
+}
+
+
+void JsonChunkSerializer::writeIndent(size_t level)
+{
+    m_pending.append(level * m_indent, m_indentCharacter);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <json.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Serializer which is pulled from instead of pushing into a sink. Every read() continues where the last one stopped,
+// so a document can be sent in chunks of whatever size the network asks for, without ever being held as a string.
+class JsonChunkSerializer
+{
+public:
+    // Same output as data->dump(indent, indentCharacter)
+    explicit JsonChunkSerializer(std::shared_ptr<const json> data, int indent = -1, char indentCharacter = ' ');
+    // Writes at most maxSize characters and returns how many were written, 0 once the document is complete
+    size_t read(char* buffer, size_t maxSize);
+
+private:
+    struct Frame
+    {
+        const json* container;
+        json::const_iterator position;
+    };
+
+    bool advance();
+    void writeValue(const json& value);
+    void writeIndent(size_t level);
+
+    std::shared_ptr<const json> m_data;
+    int m_indent;
+    char m_indentCharacter;
+    std::string m_pending;
+    size_t m_pendingPosition = 0;
+    json m_key = std::string();
+    nlohmann::detail::serializer<json> m_serializer;
+    std::vector<Frame> m_stack;
+    bool m_isStarted = false;
+};
\ No newline at end of file
@@ -0,0 +1,56 @@
+#include "JsonOutputBuffer.h"
+#include <string.h>
+
+
+JsonOutputBuffer::JsonOutputBuffer(Sink sink) noexcept :
+    m_sink(std::move(sink))
+{}
+
+
+void JsonOutputBuffer::write_character(char character)
+{
+    if (m_size == size_B)
+        flush();
+    m_buffer[m_size++] = character;
+}
+
+
+void JsonOutputBuffer::write_characters(const char* characters, size_t length)
+{
+    while (length > 0)
+    {
+        if (m_size == size_B)
+            flush();
+        size_t count = std::min(length, size_B - m_size);
+        memcpy(m_buffer + m_size, characters, count);
+        m_size += count;
+        characters += count;
+        length -= count;
+    }
+}
+
+
+void JsonOutputBuffer::flush()
+{
+    if (m_size == 0)
+        return;
+    m_sink(m_buffer, m_size);
+    m_size = 0;
+}
+
+
+void JsonOutputBuffer::serialize(const json& data, const Sink& sink, int indent, char indentCharacter)
+{
+    std::shared_ptr<JsonOutputBuffer> buffer = std::make_shared<JsonOutputBuffer>(sink);
+    nlohmann::detail::serializer<json> serializer(buffer, indentCharacter);
+    serializer.dump(data, indent >= 0, false, indent >= 0 ? indent : 0);
+    buffer->flush();
+}
+
+
+void JsonOutputBuffer::serialize(const json& data, std::ostream& stream, int indent, char indentCharacter)
+{
+    serialize(data, [&stream](const char* data, size_t size){
+        stream.write(data, size);
+    }, indent, indentCharacter);
+}
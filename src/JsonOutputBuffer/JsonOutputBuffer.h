@@ -0,0 +1,28 @@
+#pragma once
+
+#include <json.hpp>
+#include <functional>
+#include <ostream>
+
+// Output adapter for the json serializer. It collects the characters in a fixed size buffer and hands them to
+// the sink whenever the buffer is full, so a document is never held as a whole string in memory.
+class JsonOutputBuffer : public nlohmann::detail::output_adapter_protocol<char>
+{
+public:
+    using Sink = std::function<void(const char* data, size_t size)>;
+    static constexpr size_t size_B = 256;
+
+    explicit JsonOutputBuffer(Sink sink) noexcept;
+    void write_character(char character) override;
+    void write_characters(const char* characters, size_t length) override;
+    void flush();
+
+    // Same output as json::dump(indent, indentCharacter)
+    static void serialize(const json& data, const Sink& sink, int indent = -1, char indentCharacter = ' ');
+    static void serialize(const json& data, std::ostream& stream, int indent = -1, char indentCharacter = ' ');
+
+private:
+    Sink m_sink;
+    char m_buffer[size_B];
+    size_t m_size = 0;
+};
\ No newline at end of file
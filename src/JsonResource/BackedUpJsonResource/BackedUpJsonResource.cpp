@@ -1,29 +1,60 @@
 #include "BackedUpJsonResource.h"
+#include "Crc32/Crc32.h"
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "SourceLocation/SourceLocation.h"
 #include "Logger/Logger.h"
-#include <sys/time.h>
+#include <string.h>
+#include <sstream>
 
 
-BackedUpJsonResource::BackedUpJsonResource(BasicJsonResource resourceA, BasicJsonResource resourceB) :
-    m_resourceA(std::move(resourceA)),
-    m_resourceB(std::move(resourceB)),
-    m_preferredResourceForRead(&m_resourceA),
-    m_preferredResourceForWrite(&m_resourceB)
+namespace
 {
-    time_t lastWriteTimestampResourceA = 0;
-    time_t lastWriteTimestampResourceB = 0;
-    try
+    constexpr uint8_t magic[4] = {'P', 'M', 'J', 'R'};
+    constexpr size_t headerSize = 20;
+
+
+    void putUint32(uint8_t* bytes, uint32_t value) noexcept
     {
-        lastWriteTimestampResourceA = m_resourceA.getFile().getLastWriteTimestamp();
-        lastWriteTimestampResourceB = m_resourceB.getFile().getLastWriteTimestamp();
+        for (size_t i = 0; i < 4; i++)
+            bytes[i] = value >> (i * 8);
+    }
+
+
+    uint32_t getUint32(const uint8_t* bytes) noexcept
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+        return value;
     }
-    catch(...)
-    {}
 
 
-    m_preferredResourceForRead = lastWriteTimestampResourceA > lastWriteTimestampResourceB ? &m_resourceA : &m_resourceB;
-    m_preferredResourceForWrite = lastWriteTimestampResourceA > lastWriteTimestampResourceB ? &m_resourceB : &m_resourceA;
+    // Sequence numbers may wrap around
+    bool isNewer(uint32_t sequence, uint32_t otherSequence) noexcept
+    {
+        return static_cast<int32_t>(sequence - otherSequence) > 0;
+    }
+}
+
+
+BackedUpJsonResource::BackedUpJsonResource(BasicJsonResource resourceA, BasicJsonResource resourceB) :
+    m_encoding(resourceA.getEncoding()),
+    m_slotSize_B(0)
+{
+    m_resources.push_back(std::move(resourceA));
+    m_resources.push_back(std::move(resourceB));
+    m_slots[0] = {&m_resources[0].getFile(), 0, tl::nullopt};
+    m_slots[1] = {&m_resources[1].getFile(), 0, tl::nullopt};
+}
+
+
+BackedUpJsonResource::BackedUpJsonResource(BasicJsonResource resource, size_t slotSize_B) :
+    m_encoding(resource.getEncoding()),
+    m_slotSize_B(slotSize_B)
+{
+    m_resources.push_back(std::move(resource));
+    m_slots[0] = {&m_resources[0].getFile(), 0, tl::nullopt};
+    m_slots[1] = {&m_resources[0].getFile(), static_cast<std::streamoff>(slotSize_B), tl::nullopt};
 }
 
 
@@ -31,9 +62,24 @@ json BackedUpJsonResource::deserialize()
 {
     try
     {
-        return m_preferredResourceForRead->deserializeOrGet([this]{
-            std::swap(m_preferredResourceForRead, m_preferredResourceForWrite);
-            return m_preferredResourceForRead->deserialize();
+        return m_cachedData.getCached([this]{
+            readHeaders();
+            for (size_t slotIndex : getReadOrder())
+            {
+                try
+                {
+                    json data = readSlot(m_slots[slotIndex]);
+                    m_validSlotIndex = slotIndex;
+                    return data;
+                }
+                catch (...)
+                {
+                    Logger[LogLevel::Warning]
+                        << "Copy in \"" << m_slots[slotIndex].file->getPath() << "\" is not readable:\n"
+                        << ExceptionTrace::what() << std::endl;
+                }
+            }
+            throw std::runtime_error(SOURCE_LOCATION + "No readable copy");
         });
     }
     catch(...)
@@ -43,15 +89,29 @@ json BackedUpJsonResource::deserialize()
     }
 }
 
+
 void BackedUpJsonResource::serialize(const json &data)
 {
     try
     {
-        m_preferredResourceForWrite->serialize(data);
-        std::swap(m_preferredResourceForRead, m_preferredResourceForWrite);
+        readHeaders();
+        size_t newestSlotIndex = m_validSlotIndex.has_value() ? m_validSlotIndex.value() : getReadOrder().front();
+        const tl::optional<Header>& newestHeader = m_slots[newestSlotIndex].header;
+        uint32_t sequence = newestHeader.has_value() ? newestHeader->sequence + 1 : 1;
+
+        size_t slotIndex = 1 - newestSlotIndex;
+        writeSlot(m_slots[slotIndex], data, sequence);
+        m_validSlotIndex = slotIndex;
+        m_cachedData = data;
+        advanceGeneration();
     }
     catch(...)
     {
+        // The state of the written copy is unknown now
+        m_areHeadersRead = false;
+        m_validSlotIndex = tl::nullopt;
+        m_cachedData.invalidateCache();
+        advanceGeneration();
         ExceptionTrace::trace(SOURCE_LOCATION + "Failed to serialize");
         throw;
     }
@@ -62,12 +122,149 @@ void BackedUpJsonResource::remove()
 {
     try
     {
-        m_preferredResourceForRead->remove();
-        m_preferredResourceForWrite->remove();
+        m_areHeadersRead = false;
+        m_validSlotIndex = tl::nullopt;
+        m_cachedData.invalidateCache();
+        for (auto& resource : m_resources)
+            resource.remove();
+        advanceGeneration();
     }
     catch(...)
     {
         ExceptionTrace::trace(SOURCE_LOCATION + "Failed to remove");
         throw;
     }
-}
\ No newline at end of file
+}
+
+
+void BackedUpJsonResource::readHeaders()
+{
+    if (m_areHeadersRead)
+        return;
+    for (auto& slot : m_slots)
+        slot.header = readHeader(slot);
+    m_areHeadersRead = true;
+}
+
+
+tl::optional<BackedUpJsonResource::Header> BackedUpJsonResource::readHeader(const Slot& slot) const
+{
+    try
+    {
+        Filesystem::File::Stream stream = slot.file->open(std::ios::in | std::ios::binary);
+        uint8_t header[headerSize];
+        stream->seekg(slot.offset);
+        stream->read(reinterpret_cast<char*>(header), headerSize);
+        if (stream->gcount() != headerSize)
+            return tl::nullopt;
+        if (memcmp(header, magic, sizeof(magic)) != 0 || getUint32(header + 16) != Crc32::calculate(header, 16))
+            return tl::nullopt;
+
+        return Header{
+            .sequence = getUint32(header + 4),
+            .payloadSize_B = getUint32(header + 8),
+            .payloadCrc = getUint32(header + 12),
+        };
+    }
+    catch (...)
+    {
+        // Missing file
+        ExceptionTrace::clear();
+        return tl::nullopt;
+    }
+}
+
+
+std::vector<size_t> BackedUpJsonResource::getReadOrder() const
+{
+    const tl::optional<Header>& headerA = m_slots[0].header;
+    const tl::optional<Header>& headerB = m_slots[1].header;
+    if (headerA.has_value() || headerB.has_value())
+    {
+        bool isANewer = !headerB.has_value() || (headerA.has_value() && isNewer(headerA->sequence, headerB->sequence));
+        return isANewer ? std::vector<size_t>{0, 1} : std::vector<size_t>{1, 0};
+    }
+
+    // Only files written without header, which are told apart by their last write
+    time_t lastWriteTimestampA = 0;
+    time_t lastWriteTimestampB = 0;
+    try
+    {
+        lastWriteTimestampA = m_slots[0].file->getLastWriteTimestamp();
+        lastWriteTimestampB = m_slots[1].file->getLastWriteTimestamp();
+    }
+    catch (...)
+    {
+        ExceptionTrace::clear();
+    }
+    return lastWriteTimestampA > lastWriteTimestampB ? std::vector<size_t>{0, 1} : std::vector<size_t>{1, 0};
+}
+
+
+json BackedUpJsonResource::readSlot(const Slot& slot) const
+{
+    Filesystem::File::Stream stream = slot.file->open(std::ios::in | std::ios::binary);
+    if (!slot.header.has_value())
+    {
+        if (m_slotSize_B != 0)
+            throw std::runtime_error(SOURCE_LOCATION + "Slot at " + std::to_string(slot.offset) + " is empty");
+        return BasicJsonResource::decode(*stream);
+    }
+
+    std::string payload(slot.header->payloadSize_B, '\0');
+    stream->seekg(slot.offset + headerSize);
+    stream->read(&payload[0], payload.size());
+    if (static_cast<size_t>(stream->gcount()) != payload.size())
+        throw std::runtime_error(SOURCE_LOCATION + "Data is truncated");
+    if (Crc32::calculate(payload.data(), payload.size()) != slot.header->payloadCrc)
+        throw std::runtime_error(SOURCE_LOCATION + "Data does not match its CRC");
+
+    std::istringstream payloadStream(payload);
+    return BasicJsonResource::decode(payloadStream);
+}
+
+
+void BackedUpJsonResource::writeSlot(Slot& slot, const json& data, uint32_t sequence)
+{
+    slot.header = tl::nullopt;
+    Filesystem::File::Stream stream = m_slotSize_B == 0 ?
+        slot.file->open(std::ios::out | std::ios::binary) :
+        slot.file->open(std::ios::in | std::ios::out | std::ios::binary);
+
+    // Grow the file up to the slot, seeking behind the end is not supported by every stream
+    stream->seekp(0, std::ios::end);
+    std::streamoff size = stream->tellp();
+    for (; size < slot.offset; size++)
+        stream->put(0);
+
+    // The header is only written after the data, an interrupted write leaves an invalid copy behind
+    uint8_t header[headerSize] = {};
+    stream->seekp(slot.offset);
+    stream->write(reinterpret_cast<const char*>(header), headerSize);
+    uint32_t payloadSize_B = 0;
+    uint32_t payloadCrc = 0;
+    BasicJsonResource::encode(data, m_encoding, [&](const char* data, size_t size){
+        if (m_slotSize_B != 0 && headerSize + payloadSize_B + size > m_slotSize_B)
+            throw std::runtime_error(SOURCE_LOCATION + "Data does not fit into a slot of " + std::to_string(m_slotSize_B) + " bytes");
+        stream->write(data, size);
+        payloadCrc = Crc32::calculate(data, size, payloadCrc);
+        payloadSize_B += size;
+    });
+
+    memcpy(header, magic, sizeof(magic));
+    putUint32(header + 4, sequence);
+    putUint32(header + 8, payloadSize_B);
+    putUint32(header + 12, payloadCrc);
+    putUint32(header + 16, Crc32::calculate(header, 16));
+    stream->seekp(slot.offset);
+    stream->write(reinterpret_cast<const char*>(header), headerSize);
+    stream->flush();
+    if (!stream->good())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to write \"" + slot.file->getPath() + '"');
+
+    slot.header = Header{
+        .sequence = sequence,
+        .payloadSize_B = payloadSize_B,
+        .payloadCrc = payloadCrc,
+    };
+}
@@ -1,19 +1,51 @@
 #pragma once
 
 #include "JsonResource/BasicJsonResource/BasicJsonResource.h"
+#include <tl/optional.hpp>
+#include <vector>
 
+// Keeps two copies of the data and always overwrites the older one, so a torn write never loses both.
+// Each copy starts with a header holding a sequence number and the CRC of the data. Finding the newest
+// valid copy only reads the headers, corrupted data is detected before parsing it. Files written before
+// the header existed are still read, the newest of them by the last write timestamp.
 class BackedUpJsonResource : public JsonResource
 {
 public:
+    // Each copy in its own file
     BackedUpJsonResource(BasicJsonResource resourceA, BasicJsonResource resourceB);
+    // Both copies in fixed size slots of one file
+    BackedUpJsonResource(BasicJsonResource resource, size_t slotSize_B);
 
     json deserialize() override;
     void serialize(const json& data) override;
     void remove() override;
 
 private:
-    BasicJsonResource m_resourceA;
-    BasicJsonResource m_resourceB;
-    BasicJsonResource* m_preferredResourceForRead;
-    BasicJsonResource* m_preferredResourceForWrite;
-};
\ No newline at end of file
+    struct Header
+    {
+        uint32_t sequence;
+        uint32_t payloadSize_B;
+        uint32_t payloadCrc;
+    };
+
+    struct Slot
+    {
+        Filesystem::File* file;
+        std::streamoff offset;
+        tl::optional<Header> header;
+    };
+
+    void readHeaders();
+    tl::optional<Header> readHeader(const Slot& slot) const;
+    std::vector<size_t> getReadOrder() const;
+    json readSlot(const Slot& slot) const;
+    void writeSlot(Slot& slot, const json& data, uint32_t sequence);
+
+    std::vector<BasicJsonResource> m_resources;
+    BasicJsonResource::Encoding m_encoding;
+    size_t m_slotSize_B;
+    Slot m_slots[2];
+    bool m_areHeadersRead = false;
+    tl::optional<size_t> m_validSlotIndex;
+    CachedValue<json> m_cachedData;
+};
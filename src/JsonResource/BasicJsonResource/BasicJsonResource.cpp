@@ -4,9 +4,19 @@
 #include "Logger/Logger.h"
 
 
-BasicJsonResource::BasicJsonResource(std::unique_ptr<Filesystem::File> file, bool useCaching) noexcept :
+namespace
+{
+    // CBOR is written with its self-describe tag. MessagePack has no such tag, so it is preceded by 0xC1,
+    // which is never used by MessagePack. Text JSON can start with neither of them.
+    constexpr uint8_t cborSelfDescribeTag[] = {0xD9, 0xD9, 0xF7};
+    constexpr char messagePackMarker = static_cast<char>(0xC1);
+}
+
+
+BasicJsonResource::BasicJsonResource(std::unique_ptr<Filesystem::File> file, bool useCaching, Encoding encoding) noexcept :
     m_file(std::move(file)),
-    m_cachedData(CachedValue<json>(tl::nullopt, useCaching))
+    m_cachedData(CachedValue<json>(tl::nullopt, useCaching)),
+    m_encoding(encoding)
 {}
 
 
@@ -15,7 +25,7 @@ json BasicJsonResource::deserialize()
     try
     {
         return m_cachedData.getCached([this]{
-            return json::parse(*m_file->open());
+            return decode(*m_file->open(std::ios::in | std::ios::binary));
         });
     }
     catch(...)
@@ -30,11 +40,18 @@ void BasicJsonResource::serialize(const json& data)
 {
     try
     {
-        *m_file->open(std::ios::out) << data.dump(1, '\t') << std::flush;
+        Filesystem::File::Stream stream = m_file->open(std::ios::out | std::ios::binary);
+        encode(data, m_encoding, [&stream](const char* data, size_t size){
+            stream->write(data, size);
+        });
+        *stream << std::flush;
         m_cachedData = data;
+        advanceGeneration();
     }
     catch(...)
     {
+        // The file might be partially written
+        advanceGeneration();
         ExceptionTrace::trace(SOURCE_LOCATION + "Failed to serialize \"" + data.dump() + "\" to \"" + m_file->getPath() + "\"");
         throw;
     }
@@ -47,6 +64,7 @@ void BasicJsonResource::remove()
     {
         m_cachedData.invalidateCache();
         m_file->remove();
+        advanceGeneration();
     }
     catch(...)
     {
@@ -60,3 +78,47 @@ Filesystem::File& BasicJsonResource::getFile()
 {
     return *m_file;
 }
+
+
+BasicJsonResource::Encoding BasicJsonResource::getEncoding() const noexcept
+{
+    return m_encoding;
+}
+
+
+void BasicJsonResource::encode(const json& data, Encoding encoding, const JsonOutputBuffer::Sink& sink)
+{
+    if (encoding == Encoding::Text)
+    {
+        JsonOutputBuffer::serialize(data, sink, 1, '\t');
+        return;
+    }
+
+    std::shared_ptr<JsonOutputBuffer> buffer = std::make_shared<JsonOutputBuffer>(sink);
+    nlohmann::detail::binary_writer<json, char> writer(buffer);
+    if (encoding == Encoding::Cbor)
+    {
+        buffer->write_characters(reinterpret_cast<const char*>(cborSelfDescribeTag), sizeof(cborSelfDescribeTag));
+        writer.write_cbor(data);
+    }
+    else
+    {
+        buffer->write_character(messagePackMarker);
+        writer.write_msgpack(data);
+    }
+    buffer->flush();
+}
+
+
+json BasicJsonResource::decode(std::istream& stream)
+{
+    int firstByte = stream.peek();
+    if (firstByte == cborSelfDescribeTag[0])
+        return json::from_cbor(stream, true, true, json::cbor_tag_handler_t::ignore);
+    if (firstByte == static_cast<uint8_t>(messagePackMarker))
+    {
+        stream.get();
+        return json::from_msgpack(stream);
+    }
+    return json::parse(stream);
+}
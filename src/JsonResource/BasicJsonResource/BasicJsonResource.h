@@ -3,19 +3,33 @@
 #include "JsonResource/JsonResource.h"
 #include "Filesystem/File/File.h"
 #include "CachedValue/CachedValue.h"
+#include "JsonOutputBuffer/JsonOutputBuffer.h"
 #include <memory>
 
 class BasicJsonResource : public JsonResource
 {
 public:
-    BasicJsonResource(std::unique_ptr<Filesystem::File> file, bool useCaching = true) noexcept;
+    // Encoding used for writing. Reading detects the encoding, so a file written with any of them can be read.
+    enum class Encoding
+    {
+        Text,
+        Cbor,
+        MessagePack,
+    };
+
+    BasicJsonResource(std::unique_ptr<Filesystem::File> file, bool useCaching = true, Encoding encoding = Encoding::Text) noexcept;
 
     json deserialize() override;
     void serialize(const json& data) override;
     void remove() override;
     Filesystem::File& getFile();
+    Encoding getEncoding() const noexcept;
+
+    static void encode(const json& data, Encoding encoding, const JsonOutputBuffer::Sink& sink);
+    static json decode(std::istream& stream);
 
 private:
     std::unique_ptr<Filesystem::File> m_file;
     CachedValue<json> m_cachedData;
+    Encoding m_encoding;
 };
@@ -0,0 +1,189 @@
+#include "CoalescingJsonResource.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include "Logger/Logger.h"
+#include <set>
+
+
+namespace
+{
+    // Function local, so instances with static storage duration can register themselves in any order
+    std::set<CoalescingJsonResource*>& getInstances()
+    {
+        static std::set<CoalescingJsonResource*> instances;
+        return instances;
+    }
+
+
+    std::mutex& getInstancesMutex()
+    {
+        static std::mutex instancesMutex;
+        return instancesMutex;
+    }
+}
+
+
+json CoalescingJsonResource::Statistics::toJson() const
+{
+    return {
+        {"writeCount", writeCount},
+        {"unchangedCount", unchangedCount},
+        {"coalescedCount", coalescedCount},
+    };
+}
+
+
+CoalescingJsonResource::CoalescingJsonResource(std::unique_ptr<JsonResource> resource, std::chrono::milliseconds window) :
+    m_resource(std::move(resource)),
+    m_window(window)
+{
+    std::lock_guard<std::mutex> lock(getInstancesMutex());
+    getInstances().insert(this);
+}
+
+
+CoalescingJsonResource::~CoalescingJsonResource() noexcept
+{
+    {
+        std::lock_guard<std::mutex> lock(getInstancesMutex());
+        getInstances().erase(this);
+    }
+    try
+    {
+        flush(true);
+    }
+    catch (...)
+    {
+        Logger[LogLevel::Error] << "Failed to flush on destruction:\n" << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+json CoalescingJsonResource::deserialize()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_pendingData.has_value())
+        return m_pendingData.value();
+    return m_cachedData.getCached([this]{
+        return m_resource->deserialize();
+    });
+}
+
+
+void CoalescingJsonResource::serialize(const json& data)
+{
+    try
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_pendingData.has_value())
+        {
+            if (m_pendingData.value() == data)
+            {
+                m_statistics.unchangedCount++;
+                return;
+            }
+            m_statistics.coalescedCount++;
+        }
+        else
+        {
+            tl::optional<json> storedData;
+            try
+            {
+                storedData = m_cachedData.getCached([this]{
+                    return m_resource->deserialize();
+                });
+            }
+            catch (...)
+            {
+                // Nothing stored yet
+                ExceptionTrace::clear();
+            }
+            if (storedData.has_value() && storedData.value() == data)
+            {
+                m_statistics.unchangedCount++;
+                return;
+            }
+            m_firstPendingTime = std::chrono::steady_clock::now();
+        }
+
+        m_pendingData = data;
+        // Readers get the pending data right away, so it is a new generation before it reaches the resource
+        advanceGeneration();
+        if (m_window.count() == 0)
+            writePending();
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to serialize \"" + data.dump() + "\"");
+        throw;
+    }
+}
+
+
+void CoalescingJsonResource::remove()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_pendingData = tl::nullopt;
+    m_cachedData.invalidateCache();
+    m_resource->remove();
+    advanceGeneration();
+}
+
+
+void CoalescingJsonResource::flush(bool force)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_pendingData.has_value())
+        return;
+    if (force || std::chrono::steady_clock::now() - m_firstPendingTime >= m_window)
+        writePending();
+}
+
+
+CoalescingJsonResource::Statistics CoalescingJsonResource::getStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_statistics;
+}
+
+
+void CoalescingJsonResource::flushAll(bool force) noexcept
+{
+    std::lock_guard<std::mutex> lock(getInstancesMutex());
+    for (CoalescingJsonResource* instance : getInstances())
+    {
+        try
+        {
+            instance->flush(force);
+        }
+        catch (...)
+        {
+            // Stays pending and is retried with the next flush
+            Logger[LogLevel::Error] << "Failed to flush:\n" << ExceptionTrace::what() << std::endl;
+        }
+    }
+}
+
+
+CoalescingJsonResource::Statistics CoalescingJsonResource::getTotalStatistics()
+{
+    std::lock_guard<std::mutex> lock(getInstancesMutex());
+    Statistics totalStatistics;
+    for (const CoalescingJsonResource* instance : getInstances())
+    {
+        Statistics statistics = instance->getStatistics();
+        totalStatistics.writeCount += statistics.writeCount;
+        totalStatistics.unchangedCount += statistics.unchangedCount;
+        totalStatistics.coalescedCount += statistics.coalescedCount;
+    }
+    return totalStatistics;
+}
+
+
+void CoalescingJsonResource::writePending()
+{
+    m_resource->serialize(m_pendingData.value());
+    m_cachedData = m_pendingData.value();
+    m_pendingData = tl::nullopt;
+    m_statistics.writeCount++;
+}
\ No newline at end of file
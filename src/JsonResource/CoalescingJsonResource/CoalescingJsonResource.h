@@ -0,0 +1,51 @@
+#pragma once
+
+#include "JsonResource/JsonResource.h"
+#include "CachedValue/CachedValue.h"
+#include <tl/optional.hpp>
+#include <chrono>
+#include <memory>
+#include <mutex>
+
+// Decorator which avoids writes to the wrapped resource. Writing the value it already holds is dropped and
+// writes within the window after the first pending one are merged into a single write, done by flush().
+// flushAll() is meant to be called periodically by a background task. With a window of 0 every changed
+// value is written immediately.
+class CoalescingJsonResource : public JsonResource
+{
+public:
+    struct Statistics
+    {
+        json toJson() const;
+        uint32_t writeCount = 0;
+        uint32_t unchangedCount = 0;
+        uint32_t coalescedCount = 0;
+    };
+
+    CoalescingJsonResource(std::unique_ptr<JsonResource> resource, std::chrono::milliseconds window);
+    CoalescingJsonResource(const CoalescingJsonResource&) = delete;
+    CoalescingJsonResource& operator=(const CoalescingJsonResource&) = delete;
+    ~CoalescingJsonResource() noexcept override;
+
+    json deserialize() override;
+    void serialize(const json& data) override;
+    void remove() override;
+    void flush(bool force = false);
+    Statistics getStatistics() const;
+
+    // Flushes every instance whose window has passed
+    static void flushAll(bool force = false) noexcept;
+    // Sum of the statistics of all instances
+    static Statistics getTotalStatistics();
+
+private:
+    void writePending();
+
+    std::unique_ptr<JsonResource> m_resource;
+    std::chrono::milliseconds m_window;
+    CachedValue<json> m_cachedData;
+    tl::optional<json> m_pendingData;
+    std::chrono::steady_clock::time_point m_firstPendingTime;
+    Statistics m_statistics;
+    mutable std::mutex m_mutex;
+};
\ No newline at end of file
@@ -2,6 +2,18 @@
 #include "ExceptionTrace/ExceptionTrace.h"
 
 
+JsonResource::JsonResource(const JsonResource& other) noexcept :
+    m_generation(other.getGeneration())
+{}
+
+
+JsonResource& JsonResource::operator=(const JsonResource& other) noexcept
+{
+    m_generation = other.getGeneration();
+    return *this;
+}
+
+
 json JsonResource::deserializeOr(const json& defaultJson)
 {
     try
@@ -28,3 +40,15 @@ json JsonResource::deserializeOrGet(const std::function<json()>& getDefaultJson)
         return getDefaultJson();
     }
 }
+
+
+uint32_t JsonResource::getGeneration() const noexcept
+{
+    return m_generation.load();
+}
+
+
+void JsonResource::advanceGeneration() noexcept
+{
+    m_generation++;
+}
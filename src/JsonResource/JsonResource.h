@@ -1,16 +1,29 @@
 #pragma once
 
 #include <Filesystem/File/File.h>
+#include <atomic>
 #include <functional>
 #include <json.hpp>
 
 class JsonResource
 {
 public:
+    JsonResource() noexcept = default;
+    JsonResource(const JsonResource& other) noexcept;
+    JsonResource& operator=(const JsonResource& other) noexcept;
     virtual json deserialize() = 0;
     virtual void serialize(const json& data) = 0;
     virtual void remove() = 0;
     json deserializeOr(const json& defaultJson);
     json deserializeOrGet(const std::function<json()>& getDefaultJson);
+    // Advances after every change made through this resource, so readers can tell whether their copy is outdated
+    // without deserializing. It starts at 0 on every boot.
+    virtual uint32_t getGeneration() const noexcept;
     inline virtual ~JsonResource() noexcept = default;
+
+protected:
+    void advanceGeneration() noexcept;
+
+private:
+    std::atomic<uint32_t> m_generation = {0};
 };
\ No newline at end of file
@@ -1,12 +0,0 @@
-#include "Measurement.h"
-
-
-json Measurement::toJson() const
-{
-    return {
-        {"name", name},
-        {"value", value},
-        {"unit", unit},
-        {"fractionDigits", fractionDigits},
-    };
-}
\ No newline at end of file
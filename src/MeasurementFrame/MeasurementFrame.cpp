@@ -0,0 +1,118 @@
+#include "MeasurementFrame.h"
+
+
+namespace
+{
+    // Indexed by Quantity
+    constexpr MeasurementFrame::QuantityInfo quantityInfos[MeasurementFrame::quantityCount] = {
+        {"Active Power", "W", 0},
+        {"Apparent Power", "VA", 0},
+        {"Reactive Power", "var", 0},
+        {"Voltage", "V", 0},
+        {"Current", "A", 1},
+        {"Power Factor", "", 2},
+    };
+}
+
+
+constexpr size_t MeasurementFrame::quantityCount;
+
+
+const MeasurementFrame::QuantityInfo& MeasurementFrame::getInfo(Quantity quantity) noexcept
+{
+    return quantityInfos[static_cast<size_t>(quantity)];
+}
+
+
+MeasurementFrame::MeasurementFrame(const AcPower& acPower, uint32_t duration_us) noexcept :
+    m_values{
+        acPower.getActivePower_W(),
+        acPower.getApparentPower_VA(),
+        acPower.getReactivePower_var(),
+        acPower.getVoltage_V(),
+        acPower.getCurrent_A(),
+        acPower.getPowerFactor(),
+    },
+    m_signedActivePower_W(acPower.getSignedActivePower_W()),
+    m_duration_us(duration_us),
+    m_isValid(true)
+{}
+
+
+bool MeasurementFrame::isValid() const noexcept
+{
+    return m_isValid;
+}
+
+
+float MeasurementFrame::get(Quantity quantity) const noexcept
+{
+    return m_values[static_cast<size_t>(quantity)];
+}
+
+
+float MeasurementFrame::getActivePower_W() const noexcept
+{
+    return get(Quantity::ActivePower);
+}
+
+
+float MeasurementFrame::getApparentPower_VA() const noexcept
+{
+    return get(Quantity::ApparentPower);
+}
+
+
+float MeasurementFrame::getReactivePower_var() const noexcept
+{
+    return get(Quantity::ReactivePower);
+}
+
+
+float MeasurementFrame::getVoltage_V() const noexcept
+{
+    return get(Quantity::Voltage);
+}
+
+
+float MeasurementFrame::getCurrent_A() const noexcept
+{
+    return get(Quantity::Current);
+}
+
+
+float MeasurementFrame::getPowerFactor() const noexcept
+{
+    return get(Quantity::PowerFactor);
+}
+
+
+float MeasurementFrame::getSignedActivePower_W() const noexcept
+{
+    return m_signedActivePower_W;
+}
+
+
+uint32_t MeasurementFrame::getDuration_us() const noexcept
+{
+    return m_duration_us;
+}
+
+
+json MeasurementFrame::toJson() const
+{
+    json frameJson = json::array_t();
+    if (!m_isValid)
+        return frameJson;
+
+    for (size_t i = 0; i < quantityCount; i++)
+    {
+        frameJson.push_back({
+            {"name", quantityInfos[i].name},
+            {"value", m_values[i]},
+            {"unit", quantityInfos[i].unit},
+            {"fractionDigits", quantityInfos[i].fractionDigits},
+        });
+    }
+    return frameJson;
+}
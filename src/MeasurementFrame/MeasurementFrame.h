@@ -0,0 +1,60 @@
+#pragma once
+
+#include "AcPower/AcPower.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <json.hpp>
+
+
+// Quantities of a MeasurementFrame, in the order they are reported
+enum class Quantity : uint8_t
+{
+    ActivePower,
+    ApparentPower,
+    ReactivePower,
+    Voltage,
+    Current,
+    PowerFactor,
+};
+
+
+// Results of one measuring window. Holds no pointers or heap memory, so it can be copied between tasks as is.
+class MeasurementFrame
+{
+public:
+    struct QuantityInfo
+    {
+        const char* name;
+        const char* unit;
+        uint8_t fractionDigits;
+    };
+
+    static constexpr size_t quantityCount = 6;
+
+    static const QuantityInfo& getInfo(Quantity quantity) noexcept;
+
+    // Frame without any values, e.g. after a failed measurement
+    MeasurementFrame() noexcept = default;
+    // The duration covers every sample of the window, so the energy of consecutive windows has no gaps
+    explicit MeasurementFrame(const AcPower& acPower, uint32_t duration_us = 0) noexcept;
+
+    bool isValid() const noexcept;
+    float get(Quantity quantity) const noexcept;
+    float getActivePower_W() const noexcept;
+    float getApparentPower_VA() const noexcept;
+    float getReactivePower_var() const noexcept;
+    float getVoltage_V() const noexcept;
+    float getCurrent_A() const noexcept;
+    float getPowerFactor() const noexcept;
+    // Negative while exporting, unlike the reported active power
+    float getSignedActivePower_W() const noexcept;
+    uint32_t getDuration_us() const noexcept;
+    // Empty array for frames without values
+    json toJson() const;
+
+private:
+    float m_values[quantityCount] = {};
+    float m_signedActivePower_W = 0.0f;
+    uint32_t m_duration_us = 0;
+    bool m_isValid = false;
+};
\ No newline at end of file
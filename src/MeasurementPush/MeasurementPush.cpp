@@ -0,0 +1,105 @@
+#ifdef ESP32
+
+#include "MeasurementPush.h"
+#include "Logger/Logger.h"
+#include <algorithm>
+
+
+namespace
+{
+    // Size of the WebSocket frame header of a short text message
+    constexpr size_t frameHeaderSize_B = 4;
+}
+
+
+MeasurementPush::MeasurementPush(
+    AsyncWebServer* server,
+    const std::string& uri,
+    const Rtos::SeqLock<MeasurementFrame>* measurements,
+    uint32_t decimation
+) noexcept :
+    m_webSocket(new AsyncWebSocket(uri.c_str())),
+    m_measurements(measurements),
+    m_decimation(std::max<uint32_t>(decimation, 1))
+{
+    m_webSocket->onEvent([this](AsyncWebSocket*, AsyncWebSocketClient* client, AwsEventType type, void* argument, uint8_t*, size_t){
+        handleEvent(client, type, argument);
+    });
+    server->addHandler(m_webSocket);
+}
+
+
+void MeasurementPush::handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* argument)
+{
+    if (type == WS_EVT_CONNECT)
+    {
+        // Closes the oldest clients beyond the limit of the server
+        m_webSocket->cleanupClients();
+
+        AsyncWebServerRequest* request = static_cast<AsyncWebServerRequest*>(argument);
+        uint32_t decimation = m_decimation;
+        long requestedDecimation = request->hasParam("decimation") ? request->getParam("decimation")->value().toInt() : 0;
+        if (requestedDecimation > 0 && static_cast<uint32_t>(requestedDecimation) > decimation)
+            decimation = requestedDecimation;
+        // Sends the current frame on the first poll
+        client->_tempObject = new Subscriber{this, decimation, m_measurements->getGeneration() - decimation};
+
+        // Replaces the poll callback of the client, which keeps calling the one of the library first
+        client->client()->onPoll([](void* argument, AsyncClient*){
+            AsyncWebSocketClient* client = static_cast<AsyncWebSocketClient*>(argument);
+            client->_onPoll();
+            if (client->_tempObject != nullptr)
+                static_cast<Subscriber*>(client->_tempObject)->push->handlePoll(client);
+        }, client);
+
+        Logger[LogLevel::Debug]
+            << "WebSocket client " << client->id() << " subscribed to measurements, decimation "
+            << decimation << "." << std::endl;
+    }
+    else if (type == WS_EVT_DISCONNECT)
+    {
+        delete static_cast<Subscriber*>(client->_tempObject);
+        client->_tempObject = nullptr;
+    }
+}
+
+
+void MeasurementPush::handlePoll(AsyncWebSocketClient* client)
+{
+    Subscriber* subscriber = static_cast<Subscriber*>(client->_tempObject);
+    uint32_t generation = m_measurements->getGeneration();
+    if (generation - subscriber->generation < subscriber->decimation || client->status() != WS_CONNECTED)
+        return;
+    AsyncWebSocketMessageBuffer* buffer = getBuffer(generation);
+    if (buffer == nullptr)
+        return;
+    // Anything queued before is only sent once the TCP buffer has room again
+    if (client->queueIsFull() || client->client()->space() < buffer->length() + frameHeaderSize_B)
+        return;
+    client->text(buffer);
+    subscriber->generation = generation;
+}
+
+
+AsyncWebSocketMessageBuffer* MeasurementPush::getBuffer(uint32_t generation)
+{
+    if (m_buffer != nullptr && m_bufferGeneration == generation)
+        return m_buffer;
+
+    // The server frees the previous buffer once every client has sent it
+    if (m_buffer != nullptr)
+        m_buffer->unlock();
+    m_buffer = nullptr;
+    MeasurementFrame frame = m_measurements->load();
+    if (!frame.isValid())
+        return nullptr;
+    std::string frameText = frame.toJson().dump();
+    m_buffer = m_webSocket->makeBuffer(reinterpret_cast<uint8_t*>(&frameText[0]), frameText.size());
+    if (m_buffer == nullptr)
+        return nullptr;
+    m_buffer->lock();
+    m_bufferGeneration = generation;
+    return m_buffer;
+}
+
+#endif
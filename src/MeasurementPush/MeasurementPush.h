@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MeasurementFrame/MeasurementFrame.h"
+#include "Rtos/SeqLock/SeqLock.h"
+#include <ESPAsyncWebServer.h>
+#include <AsyncWebSocket.h>
+#include <string>
+
+// Pushes new measurement frames to WebSocket clients, instead of letting them poll GET /measurements.
+// The server does not guard its client list against other tasks, so everything runs in its own callbacks:
+// each client is served on its TCP poll and takes the newest frame, if it has not seen it yet.
+// Each frame is serialized once into a buffer, which is shared by all clients. A client, whose previous frames
+// are still on their way, skips the frame instead of queueing it, so it continues with the newest one.
+class MeasurementPush
+{
+public:
+    // Only every decimation-th frame is pushed. Clients can ask for a higher one with ?decimation=<n>.
+    MeasurementPush(
+        AsyncWebServer* server,
+        const std::string& uri,
+        const Rtos::SeqLock<MeasurementFrame>* measurements,
+        uint32_t decimation = 1
+    ) noexcept;
+
+private:
+    // Kept in the _tempObject of the client, which the library reserves for the application
+    struct Subscriber
+    {
+        MeasurementPush* push;
+        uint32_t decimation;
+        uint32_t generation;    // Of the last frame sent
+    };
+
+    void handleEvent(AsyncWebSocketClient* client, AwsEventType type, void* argument);
+    void handlePoll(AsyncWebSocketClient* client);
+    AsyncWebSocketMessageBuffer* getBuffer(uint32_t generation);
+
+    AsyncWebSocket* m_webSocket;    // Owned by the server
+    const Rtos::SeqLock<MeasurementFrame>* m_measurements;
+    uint32_t m_decimation;
+    AsyncWebSocketMessageBuffer* m_buffer = nullptr;    // Owned by the server, locked while it is the newest
+    uint32_t m_bufferGeneration = 0;
+};
\ No newline at end of file
@@ -5,24 +5,29 @@
 #include "SourceLocation/SourceLocation.h"
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "AcPower/AcPower.h"
-#include <EmonLib.h>
+#include "AdcSampler/I2sAdcSampler/I2sAdcSampler.h"
+#include "AcKernel/FixedPointAcKernel/FixedPointAcKernel.h"
 #include <algorithm>
 #include <math.h>
+#include <stdexcept>
 
 
-AcMeasuringUnit::AcMeasuringUnit(const json& configJson)
+namespace
+{
+    constexpr uint32_t sampleRate_Hz = 5000;
+    constexpr uint32_t measuringWindow_ms = 1000;
+    // Ends a window, which the sampler never fills, instead of blocking the measuring task for good
+    constexpr uint32_t maxEmptyBlockCount = 16;
+}
+
+
+AcMeasuringUnit::AcMeasuringUnit(const Config& config)
 {
     try
     {
-        m_emon.voltage(
-            configJson.at("/pins/voltage"_json_pointer),
-            configJson.at("/calibration/voltage"_json_pointer),
-            configJson.at("/calibration/phase"_json_pointer)
-        );
-        m_emon.current(
-            configJson.at("/pins/current"_json_pointer),
-            configJson.at("/calibration/current"_json_pointer)
-        );
+        m_kernel.reset(new FixedPointAcKernel(config.calibration));
+        m_halfCycles = config.halfCycles;
+        m_sampler.reset(new I2sAdcSampler(config.pins.voltage, config.pins.current, sampleRate_Hz));
         Logger[LogLevel::Info] << "Configured AC measuring unit sucessfully." << std::endl;
     }
     catch (...)
@@ -33,48 +38,33 @@ AcMeasuringUnit::AcMeasuringUnit(const json& configJson)
 }
 
 
-MeasurementList AcMeasuringUnit::measure() noexcept
+MeasurementFrame AcMeasuringUnit::measure(CycleRing& cycleRing) noexcept
 {
-    m_emon.calcVI(40, 4000);
-    AcPower acPower(m_emon.Vrms, m_emon.Irms, m_emon.realPower);
-    return MeasurementList {
-        Measurement {
-            .name = "Active Power",
-            .value = acPower.getActivePower_W(),
-            .unit = "W",
-            .fractionDigits = 0,
-        },
-        Measurement {
-            .name = "Apparent Power",
-            .value = acPower.getApparentPower_VA(),
-            .unit = "VA",
-            .fractionDigits = 0,
-        },
-        Measurement {
-            .name = "Reactive Power",
-            .value = acPower.getReactivePower_var(),
-            .unit = "var",
-            .fractionDigits = 0,
-        },
-        Measurement {
-            .name = "Voltage",
-            .value = acPower.getVoltage_V(),
-            .unit = "V",
-            .fractionDigits = 0,
-        },
-        Measurement {
-            .name = "Current",
-            .value = acPower.getCurrent_A(),
-            .unit = "A",
-            .fractionDigits = 1,
-        },
-        Measurement {
-            .name = "Power Factor",
-            .value = acPower.getPowerFactor(),
-            .unit = "",
-            .fractionDigits = 2,
-        },
-    };
+    m_kernel->setCycleRing(&cycleRing, m_halfCycles);
+    try
+    {
+        uint32_t emptyBlockCount = 0;
+        while (m_windowSampleCount < sampleRate_Hz * measuringWindow_ms / 1000)
+        {
+            m_sampler->read(m_block);
+            if (m_block.size == 0 && ++emptyBlockCount > maxEmptyBlockCount)
+                throw std::runtime_error(SOURCE_LOCATION + "Sampler delivered no samples");
+            m_kernel->process(m_block);
+            m_windowSampleCount += m_block.size;
+        }
+    }
+    catch (...)
+    {
+        Logger[LogLevel::Error]
+            << "Exception occurred at " << SOURCE_LOCATION << "\r\n"
+            << ExceptionTrace::what() << std::endl;
+        return MeasurementFrame();
+    }
+
+    // The result covers every sample processed since the previous one
+    uint32_t duration_us = static_cast<uint64_t>(m_windowSampleCount) * 1000000 / sampleRate_Hz;
+    m_windowSampleCount = 0;
+    return MeasurementFrame(m_kernel->getResult(), duration_us);
 }
 
 #endif
\ No newline at end of file
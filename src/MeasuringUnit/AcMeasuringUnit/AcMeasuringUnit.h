@@ -1,16 +1,59 @@
 #pragma once
 
 #include "MeasuringUnit/MeasuringUnit.h"
+#include "AdcSampler/AdcSampler.h"
+#include "AcKernel/AcKernel.h"
 #include <json.hpp>
-#include <EmonLib.h>
+#include <memory>
 
 class AcMeasuringUnit : public MeasuringUnit
 {
 public:
-    AcMeasuringUnit(const json& configJson);
+    struct Config
+    {
+        struct Pins
+        {
+            uint8_t voltage;
+            uint8_t current;
+        };
 
-    MeasurementList measure() noexcept;
+        Pins pins;
+        AcCalibration calibration;
+        bool halfCycles;
+    };
+
+    AcMeasuringUnit(const Config& config);
+
+    MeasurementFrame measure(CycleRing& cycleRing) noexcept override;
 
 private:
-    EnergyMonitor m_emon;
-};
\ No newline at end of file
+    bool m_halfCycles;
+    std::unique_ptr<AdcSampler> m_sampler;
+    std::unique_ptr<AcKernel> m_kernel;
+    AdcSampleBlock m_block;
+    // Samples processed since the previous result, a window which failed is completed by the next call
+    uint32_t m_windowSampleCount = 0;
+};
+
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AcCalibration, voltage, current, phase)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(AcMeasuringUnit::Config::Pins, voltage, current)
+
+
+inline void to_json(json& configJson, const AcMeasuringUnit::Config& config)
+{
+    configJson = {
+        {"pins", config.pins},
+        {"calibration", config.calibration},
+        {"halfCycles", config.halfCycles},
+    };
+}
+
+
+inline void from_json(const json& configJson, AcMeasuringUnit::Config& config)
+{
+    configJson.at("pins").get_to(config.pins);
+    configJson.at("calibration").get_to(config.calibration);
+    // Missing in configs written before half cycles could be measured
+    config.halfCycles = configJson.value("halfCycles", false);
+}
\ No newline at end of file
@@ -1,11 +1,13 @@
 #pragma once
 
-#include "Measurement/Measurement.h"
+#include "MeasurementFrame/MeasurementFrame.h"
+#include "CycleMeasurement/CycleMeasurement.h"
 
 
 class MeasuringUnit
 {
 public:
-    virtual MeasurementList measure() noexcept = 0;
+    // Measures one window and publishes the results of every mains cycle within it to cycleRing
+    virtual MeasurementFrame measure(CycleRing& cycleRing) noexcept = 0;
     inline virtual ~MeasuringUnit() noexcept = default;
 };
\ No newline at end of file
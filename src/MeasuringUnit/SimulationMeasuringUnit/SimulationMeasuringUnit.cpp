@@ -6,6 +6,7 @@
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "AcPower/AcPower.h"
 #include <Arduino.h>
+#include <esp_timer.h>
 #include <math.h>
 
 
@@ -15,70 +16,42 @@ namespace
     {
         return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
     }
+
+    constexpr uint32_t simulatedCycleDuration_ms = 20;
 }
 
 
-SimulationMeasuringUnit::SimulationMeasuringUnit(const json &configJson)
+SimulationMeasuringUnit::SimulationMeasuringUnit(const Config& config) :
+    m_config(config)
 {
-    try
-    {
-        m_minVoltage = configJson.at("/voltage/min"_json_pointer);
-        m_maxVoltage = configJson.at("/voltage/max"_json_pointer);
-        m_minCurrent = configJson.at("/current/min"_json_pointer);
-        m_maxCurrent = configJson.at("/current/max"_json_pointer);
-        m_minPowerFactor = configJson.at("/powerFactor/min"_json_pointer);
-        m_maxPowerFactor = configJson.at("/powerFactor/max"_json_pointer);
-        m_measuringRunTime_ms = configJson.at("measuringRunTime_ms");
-        Logger[LogLevel::Info] << "Configured simulation measuring unit sucessfully." << std::endl;
-    }
-    catch (...)
-    {
-        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to configures simulated measuring unit");
-        throw;
-    }
+    Logger[LogLevel::Info] << "Configured simulation measuring unit sucessfully." << std::endl;
 }
 
 
-MeasurementList SimulationMeasuringUnit::measure() noexcept
+MeasurementFrame SimulationMeasuringUnit::measure(CycleRing& cycleRing) noexcept
 {
-    delayMicroseconds(m_measuringRunTime_ms * 1000);
-    float simulatedVoltage = randomInRange(m_minVoltage, m_maxVoltage);
-    float simulatedCurrent = randomInRange(m_minCurrent, m_maxCurrent);
-    float simulatedPowerFactor = randomInRange(m_minPowerFactor, m_maxPowerFactor);
+    delay(m_config.measuringRunTime_ms);
+    float simulatedVoltage = randomInRange(m_config.voltage.min, m_config.voltage.max);
+    float simulatedCurrent = randomInRange(m_config.current.min, m_config.current.max);
+    float simulatedPowerFactor = randomInRange(m_config.powerFactor.min, m_config.powerFactor.max);
     float simulatedActivePower = simulatedVoltage * simulatedCurrent * simulatedPowerFactor;
-    AcPower acPower(simulatedVoltage, simulatedCurrent, simulatedActivePower);
-    return MeasurementList {
-        Measurement {
-            .name = "Active Power",
-            .value = acPower.getActivePower_W(),
-            .unit = "W",
-        },
-        Measurement {
-            .name = "Apparent Power",
-            .value = acPower.getApparentPower_VA(),
-            .unit = "VA",
-        },
-        Measurement {
-            .name = "Reactive Power",
-            .value = acPower.getReactivePower_var(),
-            .unit = "var",
-        },
-        Measurement {
-            .name = "Voltage",
-            .value = acPower.getVoltage_V(),
-            .unit = "V",
-        },
-        Measurement {
-            .name = "Current",
-            .value = acPower.getCurrent_A(),
-            .unit = "A",
-        },
-        Measurement {
-            .name = "Power Factor",
-            .value = acPower.getPowerFactor(),
-            .unit = "",
-        },
-    };
+
+    uint64_t now_us = esp_timer_get_time();
+    uint32_t cycleCount = m_config.measuringRunTime_ms / simulatedCycleDuration_ms;
+    for (uint32_t i = 0; i < cycleCount; i++)
+    {
+        cycleRing.push(CycleMeasurement {
+            .timestamp_us = now_us - (cycleCount - 1 - i) * simulatedCycleDuration_ms * 1000,
+            .duration_us = simulatedCycleDuration_ms * 1000,
+            .voltage_V = simulatedVoltage,
+            .current_A = simulatedCurrent,
+            .activePower_W = simulatedActivePower,
+        });
+    }
+    return MeasurementFrame(
+        AcPower(simulatedVoltage, simulatedCurrent, simulatedActivePower),
+        m_config.measuringRunTime_ms * 1000
+    );
 }
 
 #endif
\ No newline at end of file
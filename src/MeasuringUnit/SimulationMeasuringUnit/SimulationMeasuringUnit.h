@@ -6,16 +6,28 @@
 class SimulationMeasuringUnit : public MeasuringUnit
 {
 public:
-    SimulationMeasuringUnit(const json& configJson);
+    struct Config
+    {
+        struct Range
+        {
+            float min;
+            float max;
+        };
 
-    MeasurementList measure() noexcept override;
+        uint32_t measuringRunTime_ms;
+        Range voltage;
+        Range current;
+        Range powerFactor;
+    };
+
+    SimulationMeasuringUnit(const Config& config);
+
+    MeasurementFrame measure(CycleRing& cycleRing) noexcept override;
 
 private:
-    float m_minVoltage;
-    float m_maxVoltage;
-    float m_minCurrent;
-    float m_maxCurrent;
-    float m_minPowerFactor;
-    float m_maxPowerFactor;
-    uint32_t m_measuringRunTime_ms;
-};
\ No newline at end of file
+    Config m_config;
+};
+
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SimulationMeasuringUnit::Config::Range, min, max)
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(SimulationMeasuringUnit::Config, measuringRunTime_ms, voltage, current, powerFactor)
\ No newline at end of file
@@ -4,23 +4,16 @@
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "SourceLocation/SourceLocation.h"
 #include "Logger/Logger.h"
+#include "JsonChunkSerializer/JsonChunkSerializer.h"
 #include <sstream>
+#include <algorithm>
+#include <stdlib.h>
+#include <string.h>
+#include <esp_system.h>
 
 
 namespace
 {
-    std::string escapeSlashes(const std::string& input)
-    {
-        std::string result;
-        for (char c : input)
-        {
-            if (c == '/')
-                result += '\\';
-            result += c;
-        }
-        return result;
-    }
-
     std::string methodToString(WebRequestMethod method)
     {
         switch (method)
@@ -44,98 +37,256 @@ namespace
     }
 }
 
-RestApi::RestApi(AsyncWebServer &server, const Version& apiVersion, const std::string &baseUri) noexcept :
-    m_server(server),
-    m_apiVersion(apiVersion),
-    m_baseUri(baseUri)
-{
-    std::stringstream uriRegex;
-    uriRegex << '^' << escapeSlashes(m_baseUri) << "/(.*)$";
-    m_server.on(uriRegex.str().c_str(), HTTP_OPTIONS, [](AsyncWebServerRequest* request){
-        AsyncWebServerResponse* response = request->beginResponse(200);
-        response->addHeader("Access-Control-Allow-Origin", "*");
-        response->addHeader("Access-Control-Allow-Methods", "*");
-        request->send(response);
-    });
-}
 
-void RestApi::handle(const std::string &uri, WebRequestMethod method, const JsonHandler &handler) noexcept
+// The only handler registered at the server, it hands every request below the base URI to the RestApi
+class RestApi::Dispatcher : public AsyncWebHandler
 {
-    static bool alreadyHandled = false;
-    alreadyHandled = false;
-    auto serverHandler = [this, handler, method, uri](AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) {
-        JsonResponse jsonResponse(json(), 500);
-        try
+public:
+    explicit Dispatcher(const RestApi* restApi) noexcept :
+        m_restApi(restApi)
+    {}
+
+    bool canHandle(AsyncWebServerRequest* request) override
+    {
+        if (request->method() == HTTP_OPTIONS)
         {
-            Version requestedApiVersion(request->pathArg(0).c_str());
-            if (requestedApiVersion > m_apiVersion)
+            const String& url = request->url();
+            return url.startsWith(m_restApi->m_baseUri.c_str()) && url.charAt(m_restApi->m_baseUri.size()) == '/';
+        }
+        // All other headers are dropped once the request is attached to a handler
+        request->addInterestingHeader("If-None-Match");
+        return m_restApi->resolve(*request).has_value();
+    }
+
+    void handleRequest(AsyncWebServerRequest* request) override
+    {
+        if (request->method() == HTTP_OPTIONS)
+        {
+            AsyncWebServerResponse* response = request->beginResponse(200);
+            response->addHeader("Access-Control-Allow-Origin", "*");
+            response->addHeader("Access-Control-Allow-Methods", "*");
+            request->send(response);
+            return;
+        }
+        // Requests with a body that is too large have already been answered by handleBody()
+        if (request->contentLength() > m_restApi->m_maxBodySize_B)
+            return;
+        // handleBody() is not called for form data, any other body without a buffer did not fit into the heap
+        if (
+            request->contentLength() > 0 &&
+            request->_tempObject == nullptr &&
+            !request->contentType().startsWith("application/x-www-form-urlencoded")
+        )
+        {
+            std::stringstream errorMessage;
+            errorMessage
+                << SOURCE_LOCATION << "Not enough memory to buffer the request body of "
+                << request->contentLength() << " B";
+            m_restApi->send(request, JsonResponse(json::array({errorMessage.str()}), 503, {{"Retry-After", "1"}}));
+            return;
+        }
+        m_restApi->dispatch(request, static_cast<const char*>(request->_tempObject), request->contentLength());
+    }
+
+    // Collects the chunks of the body in _tempObject, which the request frees once it is done
+    void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) override
+    {
+        if (total > m_restApi->m_maxBodySize_B)
+        {
+            // Rejected at the first chunk, before anything is buffered
+            if (index == 0)
             {
                 std::stringstream errorMessage;
                 errorMessage
-                    << "The requested API version (v" << requestedApiVersion << ") is not available. "
-                    << "The latest available API version is v" << m_apiVersion << ". "
-                    << "Try updating to the latest firmware.";
-                throw std::runtime_error(SOURCE_LOCATION + errorMessage.str());
+                    << SOURCE_LOCATION << "The request body of " << total << " B exceeds the maximum of "
+                    << m_restApi->m_maxBodySize_B << " B";
+                m_restApi->send(request, JsonResponse(json::array({errorMessage.str()}), 413));
             }
-            json requestJson;
-            if (length > 0)
+            return;
+        }
+        if (index == 0)
+            request->_tempObject = malloc(total);
+        if (request->_tempObject != nullptr && index + length <= total)
+            memcpy(static_cast<uint8_t*>(request->_tempObject) + index, data, length);
+    }
+
+    bool isRequestHandlerTrivial() override
+    {
+        return false;
+    }
+
+private:
+    const RestApi* m_restApi;
+};
+
+
+RestApi::RestApi(AsyncWebServer &server, const Version& apiVersion, const std::string &baseUri, size_t maxBodySize_B) noexcept :
+    m_apiVersion(apiVersion),
+    m_baseUri(baseUri),
+    m_maxBodySize_B(maxBodySize_B),
+    m_bootId(esp_random())
+{
+    server.addHandler(new Dispatcher(this));
+}
+
+
+void RestApi::handle(
+    const std::string &uri,
+    WebRequestMethod method,
+    const JsonHandler &handler,
+    const GenerationGetter& getGeneration
+) noexcept
+{
+    try
+    {
+        m_routes.add(uri, method, m_endpoints.size());
+        m_endpoints.push_back(Endpoint{uri, method, handler, getGeneration});
+    }
+    catch (...)
+    {
+        Logger[LogLevel::Error]
+            << "Exception occurred at " << SOURCE_LOCATION << "\r\n"
+            << "Failed to add \"" << methodToString(method) << " " << uri << "\": " << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+tl::optional<RestApi::Route> RestApi::resolve(const AsyncWebServerRequest& request) const
+{
+    // Paths look like <base URI>/v<API version><endpoint URI>
+    std::string url = request.url().c_str();
+    std::string prefix = m_baseUri + "/v";
+    if (url.compare(0, prefix.size(), prefix) != 0)
+        return tl::nullopt;
+    size_t versionEnd = std::min(url.find('/', prefix.size()), url.size());
+
+    tl::optional<RouteTrie::Match> match = m_routes.match(url.substr(versionEnd), request.method());
+    if (!match.has_value())
+        return tl::nullopt;
+    return Route{url.substr(prefix.size(), versionEnd - prefix.size()), std::move(match.value())};
+}
+
+
+void RestApi::dispatch(AsyncWebServerRequest* request, const char* body, size_t size_B) const
+{
+    tl::optional<Route> route = resolve(*request);
+    if (!route.has_value())
+    {
+        request->send(404);
+        return;
+    }
+    const Endpoint& endpoint = m_endpoints[route->match.handlerId];
+
+    JsonResponse jsonResponse(json(), 500);
+    std::string eTagHeader;
+    try
+    {
+        Version requestedApiVersion(route->version);
+        if (requestedApiVersion > m_apiVersion)
+        {
+            std::stringstream errorMessage;
+            errorMessage
+                << "The requested API version (v" << requestedApiVersion << ") is not available. "
+                << "The latest available API version is v" << m_apiVersion << ". "
+                << "Try updating to the latest firmware.";
+            throw std::runtime_error(SOURCE_LOCATION + errorMessage.str());
+        }
+
+        if (endpoint.getGeneration && request->method() == HTTP_GET)
+        {
+            // Taken before the handler runs, so a change in between makes the ETag outdated instead of wrong
+            std::stringstream eTag;
+            eTag
+                << '"' << std::hex << m_bootId << '-' << endpoint.getGeneration()
+                << (request->hasParam("pretty") ? "-pretty" : "") << '"';
+            if (request->hasHeader("If-None-Match") && request->header("If-None-Match").indexOf(eTag.str().c_str()) >= 0)
             {
-                std::string body(reinterpret_cast<const char*>(data));
-                body.resize(length);
-                requestJson = json::parse(body);
+                send(request, JsonResponse(nullptr, 304, {{"ETag", eTag.str()}}));
+                return;
             }
+            eTagHeader = eTag.str();
+        }
+
+        json requestJson;
+        if (size_B > 0)
+        {
+            // Form data is parsed into parameters by the server instead
+            if (body == nullptr)
+                throw std::runtime_error(SOURCE_LOCATION + "The request body is not JSON");
+            requestJson = json::parse(body, body + size_B);
+        }
+        try
+        {
+            jsonResponse = endpoint.handler(JsonRequest {
+                .data = std::move(requestJson),
+                .version = requestedApiVersion,
+                .params = std::move(route->match.params),
+                .serverRequest = *request,
+            });
+        }
+        catch (...)
+        {
+            ExceptionTrace::trace(SOURCE_LOCATION + "Request handler for \"" + methodToString(endpoint.method) + " " + endpoint.uri + "\" failed");
+            throw;
+        }
+    }
+    catch (...)
+    {
+        Logger[LogLevel::Error]
+            << "Exception occurred at "
+            << SOURCE_LOCATION << "\r\n"
+            << ExceptionTrace::what(false) << std::endl;
+        jsonResponse.data = ExceptionTrace::get();
+        jsonResponse.sharedData = nullptr;
+        eTagHeader.clear();
+    }
+    if (!eTagHeader.empty() && jsonResponse.statusCode == 200)
+        jsonResponse.headers["ETag"] = eTagHeader;
+    send(request, std::move(jsonResponse));
+}
+
+
+void RestApi::send(AsyncWebServerRequest* request, JsonResponse jsonResponse) const
+{
+    AsyncWebServerResponse* response;
+    bool isWithoutBody = jsonResponse.statusCode == 204 || jsonResponse.statusCode == 304;
+    if (jsonResponse.data == nullptr && jsonResponse.sharedData == nullptr && isWithoutBody)
+    {
+        response = request->beginResponse(jsonResponse.statusCode);
+    }
+    else
+    {
+        if (jsonResponse.sharedData == nullptr)
+            jsonResponse.sharedData = std::make_shared<const json>(std::move(jsonResponse.data));
+        // Compact unless asked for, indentation makes up a large part of big responses
+        int indent = request->hasParam("pretty") ? 1 : -1;
+        // Serialized chunk by chunk while the response is sent, so the document never exists as a string
+        std::shared_ptr<JsonChunkSerializer> serializer = std::make_shared<JsonChunkSerializer>(
+            std::move(jsonResponse.sharedData),
+            indent,
+            '\t'
+        );
+        response = request->beginChunkedResponse("application/json", [serializer](uint8_t* buffer, size_t maxLength, size_t){
             try
             {
-                jsonResponse = handler(JsonRequest {
-                    .data = requestJson,
-                    .version = requestedApiVersion,
-                    .serverRequest = *request,
-                });
+                return serializer->read(reinterpret_cast<char*>(buffer), maxLength);
             }
             catch (...)
             {
-                ExceptionTrace::trace(SOURCE_LOCATION + "Request handler for \"" + methodToString(method) + " " + uri + "\" failed");
-                throw;
+                Logger[LogLevel::Error]
+                    << "Exception occurred at " << SOURCE_LOCATION << "\r\n"
+                    << ExceptionTrace::what() << std::endl;
+                return static_cast<size_t>(0);
             }
-        }
-        catch (...)
-        {
-            Logger[LogLevel::Error]
-                << "Exception occurred at "
-                << SOURCE_LOCATION << "\r\n"
-                << ExceptionTrace::what(false) << std::endl;
-            jsonResponse.data = ExceptionTrace::get();
-        }
-        AsyncWebServerResponse* response = request->beginResponse(
-            jsonResponse.statusCode,
-            "application/json",
-            (jsonResponse.data == nullptr && jsonResponse.statusCode == 204 ) ? "" : jsonResponse.data.dump(-1, '\t').c_str()
-        );
-        response->addHeader("Access-Control-Allow-Origin", "*");
-        for (const auto& header : jsonResponse.headers)
-            response->addHeader(header.first.c_str(), header.second.c_str());
-        request->send(response);
-        delay(100);
-        jsonResponse.doAfterSend();
-    };
-
-    std::stringstream uriRegex;
-    uriRegex << '^' << escapeSlashes(m_baseUri) << "/v(.*)" << escapeSlashes(uri) << "$";
-
-    m_server.on(
-        uriRegex.str().c_str(),
-        method,
-        [serverHandler](AsyncWebServerRequest* request){
-            if (!alreadyHandled)
-                serverHandler(request, nullptr, 0, 0, 0);
-            alreadyHandled = false;
-        },
-        nullptr,
-        [serverHandler](AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) {
-            alreadyHandled = true;
-            serverHandler(request, data, length, index, total);
-        }
-    );
+        });
+        response->setCode(jsonResponse.statusCode);
+    }
+    response->addHeader("Access-Control-Allow-Origin", "*");
+    for (const auto& header : jsonResponse.headers)
+        response->addHeader(header.first.c_str(), header.second.c_str());
+    request->send(response);
+    delay(100);
+    jsonResponse.doAfterSend();
 }
 
 #endif
\ No newline at end of file
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "Version/Version.h"
+#include "RouteTrie/RouteTrie.h"
 #include <json.hpp>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 #include <ESPAsyncWebServer.h>
 
 namespace Http
@@ -19,6 +22,7 @@ public:
     {
         json data;
         Version version;
+        RouteTrie::Params params;
         const AsyncWebServerRequest& serverRequest;
     };
 
@@ -35,19 +39,78 @@ public:
             headers(headers),
             doAfterSend(doAfterSend)
         {}
+
+        // Response which is serialized straight from a snapshot shared with its owner, instead of from a copy
+        static inline JsonResponse share(
+            std::shared_ptr<const json> data,
+            uint16_t statusCode = 200,
+            const Http::HeaderMap& headers = {}
+        )
+        {
+            JsonResponse response(nullptr, statusCode, headers);
+            response.sharedData = std::move(data);
+            return response;
+        }
+
         json data;
+        std::shared_ptr<const json> sharedData;
         uint16_t statusCode;
         Http::HeaderMap headers;
         std::function<void()> doAfterSend;
     };
 
     using JsonHandler = std::function<JsonResponse(JsonRequest)>;
+    // Returns a number which advances whenever the response of a GET endpoint changes
+    using GenerationGetter = std::function<uint32_t()>;
 
-    RestApi(AsyncWebServer& server, const Version& apiVersion, const std::string& baseUri = "") noexcept;
-    void handle(const std::string& uri, WebRequestMethod method, const JsonHandler& handler) noexcept;
+    // Enough for importing the data of all default trackers at once. The body is buffered in one block, which
+    // has to be small enough to be found in a fragmented heap.
+    static constexpr size_t defaultMaxBodySize_B = 8 * 1024;
+
+    // Requests with a larger body than maxBodySize_B are answered with 413 without buffering the body,
+    // requests whose body does not fit into the free heap with 503
+    RestApi(
+        AsyncWebServer& server,
+        const Version& apiVersion,
+        const std::string& baseUri = "",
+        size_t maxBodySize_B = defaultMaxBodySize_B
+    ) noexcept;
+    // uri is a RouteTrie pattern, its parameters are passed to the handler as JsonRequest::params.
+    // With getGeneration, responses get an ETag, and requests which already have the current one are answered
+    // with 304 without calling the handler.
+    void handle(
+        const std::string& uri,
+        WebRequestMethod method,
+        const JsonHandler& handler,
+        const GenerationGetter& getGeneration = nullptr
+    ) noexcept;
 
 private:
-    AsyncWebServer& m_server;
+    class Dispatcher;
+
+    struct Endpoint
+    {
+        std::string uri;
+        WebRequestMethod method;
+        JsonHandler handler;
+        GenerationGetter getGeneration;
+    };
+
+    struct Route
+    {
+        std::string version;
+        RouteTrie::Match match;
+    };
+
+    tl::optional<Route> resolve(const AsyncWebServerRequest& request) const;
+    void dispatch(AsyncWebServerRequest* request, const char* body, size_t size_B) const;
+    void send(AsyncWebServerRequest* request, JsonResponse jsonResponse) const;
+
     Version m_apiVersion;
     std::string m_baseUri;
+    size_t m_maxBodySize_B;
+    // Part of every ETag, since generations start over on every boot
+    uint32_t m_bootId;
+    RouteTrie m_routes;
+    std::vector<Endpoint> m_endpoints;
 };
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "RouteTrie.h"
+
+
+void RouteTrie::Params::add(std::string name, std::string value)
+{
+    m_params.emplace_back(std::move(name), std::move(value));
+}
+
+
+bool RouteTrie::Params::has(const std::string& name) const noexcept
+{
+    for (const auto& param : m_params)
+    {
+        if (param.first == name)
+            return true;
+    }
+    return false;
+}
+
+
+const std::string& RouteTrie::Params::getString(const std::string& name) const
+{
+    for (const auto& param : m_params)
+    {
+        if (param.first == name)
+            return param.second;
+    }
+    throw std::runtime_error(SOURCE_LOCATION + "There is no parameter \"" + name + "\"");
+}
+
+
+void RouteTrie::add(const std::string& pattern, Methods methods, size_t handlerId)
+{
+    Node* node = &m_root;
+    std::vector<std::string> segments = split(pattern);
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        const std::string& segment = segments[i];
+        Node::Type type = Node::Type::Literal;
+        std::string name = segment;
+        if (segment.size() > 2 && segment.front() == '{' && segment.back() == '}')
+        {
+            name = segment.substr(1, segment.size() - 2);
+            type = Node::Type::Parameter;
+            if (name.back() == '*')
+            {
+                if (i != segments.size() - 1)
+                    throw std::runtime_error(SOURCE_LOCATION + "\"" + segment + "\" has to be the last segment of \"" + pattern + "\"");
+                name.pop_back();
+                type = Node::Type::Rest;
+            }
+        }
+
+        Node* child = nullptr;
+        for (const auto& existingChild : node->children)
+        {
+            if (existingChild->type == type && existingChild->segment == name)
+                child = existingChild.get();
+        }
+        if (child == nullptr)
+        {
+            node->children.emplace_back(new Node{type, std::move(name), {}, {}});
+            child = node->children.back().get();
+        }
+        node = child;
+    }
+
+    for (const auto& handler : node->handlers)
+    {
+        if (handler.first & methods)
+            throw std::runtime_error(SOURCE_LOCATION + "\"" + pattern + "\" is already handled");
+    }
+    node->handlers.emplace_back(methods, handlerId);
+}
+
+
+tl::optional<RouteTrie::Match> RouteTrie::match(const std::string& path, Methods method) const
+{
+    Match result{0, Params()};
+    if (!match(m_root, split(path), 0, method, result))
+        return tl::nullopt;
+    return result;
+}
+
+
+std::vector<std::string> RouteTrie::split(const std::string& path)
+{
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (start < path.size())
+    {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos)
+            end = path.size();
+        if (end > start)
+            segments.push_back(path.substr(start, end - start));
+        start = end + 1;
+    }
+    return segments;
+}
+
+
+tl::optional<size_t> RouteTrie::getHandlerId(const Node& node, Methods method) noexcept
+{
+    for (const auto& handler : node.handlers)
+    {
+        if (handler.first & method)
+            return handler.second;
+    }
+    return tl::nullopt;
+}
+
+
+bool RouteTrie::match(const Node& node, const std::vector<std::string>& segments, size_t index, Methods method, Match& result)
+{
+    if (index == segments.size())
+    {
+        tl::optional<size_t> handlerId = getHandlerId(node, method);
+        if (handlerId.has_value())
+        {
+            result.handlerId = handlerId.value();
+            return true;
+        }
+    }
+
+    for (Node::Type type : {Node::Type::Literal, Node::Type::Parameter, Node::Type::Rest})
+    {
+        for (const auto& child : node.children)
+        {
+            if (child->type != type)
+                continue;
+
+            if (type == Node::Type::Rest)
+            {
+                tl::optional<size_t> handlerId = getHandlerId(*child, method);
+                if (!handlerId.has_value())
+                    continue;
+                std::string rest;
+                for (size_t i = index; i < segments.size(); i++)
+                    rest += (i == index ? "" : "/") + segments[i];
+                result.params.add(child->segment, std::move(rest));
+                result.handlerId = handlerId.value();
+                return true;
+            }
+
+            if (index == segments.size())
+                continue;
+            if (type == Node::Type::Literal && child->segment != segments[index])
+                continue;
+
+            if (type == Node::Type::Parameter)
+                result.params.add(child->segment, segments[index]);
+            if (match(*child, segments, index + 1, method, result))
+                return true;
+            if (type == Node::Type::Parameter)
+                result.params.m_params.pop_back();
+        }
+    }
+    return false;
+}
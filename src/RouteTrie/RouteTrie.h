@@ -0,0 +1,91 @@
+#pragma once
+
+#include "SourceLocation/SourceLocation.h"
+#include <tl/optional.hpp>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+// Resolves a path and method to a handler by walking a trie of path segments. It is built once while the
+// endpoints are registered, so a request costs one step per segment no matter how many endpoints there are.
+class RouteTrie
+{
+public:
+    // Bit mask of methods, like WebRequestMethod
+    using Methods = uint8_t;
+
+    // Values of the parameters of a pattern, by name
+    class Params
+    {
+    public:
+        void add(std::string name, std::string value);
+        bool has(const std::string& name) const noexcept;
+
+        template<typename T = std::string>
+        T get(const std::string& name) const
+        {
+            std::istringstream stream(getString(name));
+            T value;
+            if (!(stream >> value) || stream.peek() != std::istringstream::traits_type::eof())
+                throw std::runtime_error(SOURCE_LOCATION + "\"" + getString(name) + "\" is not a valid " + name);
+            return value;
+        }
+
+    private:
+        friend class RouteTrie;
+        const std::string& getString(const std::string& name) const;
+
+        std::vector<std::pair<std::string, std::string>> m_params;
+    };
+
+    struct Match
+    {
+        size_t handlerId;
+        Params params;
+    };
+
+    // Segments of the pattern are literals, "{name}" for any single segment,
+    // or "{name*}" as the last segment for the rest of the path, which may be empty
+    void add(const std::string& pattern, Methods methods, size_t handlerId);
+    // Literal segments take precedence over parameters, parameters over the rest of the path
+    tl::optional<Match> match(const std::string& path, Methods method) const;
+
+private:
+    struct Node
+    {
+        enum class Type : uint8_t
+        {
+            Literal,
+            Parameter,
+            Rest,
+        };
+
+        Type type;
+        std::string segment;    // Name of the parameter for anything else than literals
+        std::vector<std::unique_ptr<Node>> children;
+        std::vector<std::pair<Methods, size_t>> handlers;
+    };
+
+    static std::vector<std::string> split(const std::string& path);
+    static tl::optional<size_t> getHandlerId(const Node& node, Methods method) noexcept;
+    static bool match(
+        const Node& node,
+        const std::vector<std::string>& segments,
+        size_t index,
+        Methods method,
+        Match& match
+    );
+
+    Node m_root = Node{Node::Type::Literal, "", {}, {}};
+};
+
+template<>
+inline std::string RouteTrie::Params::get<std::string>(const std::string& name) const
+{
+    return getString(name);
+}
\ No newline at end of file
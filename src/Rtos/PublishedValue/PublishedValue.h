@@ -0,0 +1,41 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+namespace Rtos
+{
+    // Read-copy-update cell: the writer publishes a complete new value, readers keep the value they got
+    // for as long as they need it. Readers never wait for a writer preparing the next value.
+    template<typename T>
+    class PublishedValue
+    {
+    public:
+        PublishedValue() :
+            m_value(std::make_shared<const T>())
+        {}
+
+        inline std::shared_ptr<const T> get() const noexcept
+        {
+            return std::atomic_load(&m_value);
+        }
+
+        inline void publish(T value)
+        {
+            std::shared_ptr<const T> newValue = std::make_shared<const T>(std::move(value));
+            std::atomic_store(&m_value, std::move(newValue));
+            m_generation.fetch_add(1, std::memory_order_release);
+        }
+
+        // Advances after every publish. Read before get(), it never claims a value newer than the one returned.
+        inline uint32_t getGeneration() const noexcept
+        {
+            return m_generation.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::shared_ptr<const T> m_value;
+        std::atomic<uint32_t> m_generation = {0};
+    };
+}
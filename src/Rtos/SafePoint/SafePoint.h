@@ -0,0 +1,62 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+
+namespace Rtos
+{
+    // Runs a function on the task owning a resource, at a point where that task does not use the resource,
+    // e.g. between two measuring windows. The calling task waits until the function ran and gets its exception.
+    // Passing the point without anything pending costs the owning task a single atomic load.
+    class SafePoint
+    {
+    public:
+        // Must only be called by the owning task
+        void pass()
+        {
+            if (!m_isPending.load(std::memory_order_acquire))
+                return;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            try
+            {
+                m_function();
+            }
+            catch (...)
+            {
+                m_exception = std::current_exception();
+            }
+            m_function = nullptr;
+            m_isPending.store(false, std::memory_order_release);
+            lock.unlock();
+            m_isDone.notify_all();
+        }
+
+        // Waits for the owning task to pass the point, so it must not be called by the owning task itself
+        void run(std::function<void()> function)
+        {
+            std::lock_guard<std::mutex> callerLock(m_callerMutex);
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_function = std::move(function);
+            m_exception = nullptr;
+            m_isPending.store(true, std::memory_order_release);
+            m_isDone.wait(lock, [this]{
+                return !m_isPending.load(std::memory_order_acquire);
+            });
+            if (m_exception)
+                std::rethrow_exception(m_exception);
+        }
+
+    private:
+        // Only one function is pending at a time
+        std::mutex m_callerMutex;
+        std::mutex m_mutex;
+        std::condition_variable m_isDone;
+        std::atomic<bool> m_isPending = {false};
+        std::function<void()> m_function;
+        std::exception_ptr m_exception;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <thread>
+#include <type_traits>
+
+namespace Rtos
+{
+    // Sequence lock for a single writer: the writer never waits and never allocates, readers copy the value
+    // and retry if a write overlapped the copy. Meant for small values published at a high rate, like the
+    // latest measurements of the sampling task. The value is held in atomic words, so copying it is no data race.
+    template<typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock can only hold trivially copyable values");
+
+    public:
+        SeqLock() noexcept :
+            SeqLock(T())
+        {}
+
+        explicit SeqLock(const T& value) noexcept
+        {
+            storeWords(value);
+        }
+
+        // Must only be called by one task at a time
+        void store(const T& value) noexcept
+        {
+            uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+            // An odd sequence tells readers that a write is in progress
+            m_sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            storeWords(value);
+            m_sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        T load() const noexcept
+        {
+            std::array<uint32_t, wordCount> words;
+            while (true)
+            {
+                uint32_t sequence = m_sequence.load(std::memory_order_acquire);
+                if ((sequence & 1) == 0)
+                {
+                    for (size_t i = 0; i < wordCount; i++)
+                        words[i] = m_words[i].load(std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (m_sequence.load(std::memory_order_relaxed) == sequence)
+                        break;
+                }
+                m_retryCount.fetch_add(1, std::memory_order_relaxed);
+                // Lets the writer finish, in case it was preempted on the same core
+                std::this_thread::yield();
+            }
+
+            T value;
+            memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+            return value;
+        }
+
+        // Advances with every store. Read before load(), it never claims a value newer than the one returned.
+        uint32_t getGeneration() const noexcept
+        {
+            return m_sequence.load(std::memory_order_acquire) / 2;
+        }
+
+        // Reads, which overlapped a write and had to be repeated
+        uint32_t getRetryCount() const noexcept
+        {
+            return m_retryCount.load(std::memory_order_relaxed);
+        }
+
+    private:
+        static constexpr size_t wordCount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+        void storeWords(const T& value) noexcept
+        {
+            std::array<uint32_t, wordCount> words = {};
+            memcpy(words.data(), &value, sizeof(T));
+            for (size_t i = 0; i < wordCount; i++)
+                m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        std::atomic<uint32_t> m_sequence = {0};
+        std::array<std::atomic<uint32_t>, wordCount> m_words;
+        mutable std::atomic<uint32_t> m_retryCount = {0};
+    };
+}
\ No newline at end of file
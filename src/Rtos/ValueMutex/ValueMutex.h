@@ -1,9 +1,31 @@
 #pragma once
 
+#include <chrono>
 #include <mutex>
+#include <stdint.h>
+#include <json.hpp>
 
 namespace Rtos
 {
+    struct LockWaitStatistics
+    {
+        json toJson() const
+        {
+            return {
+                {"lockCount", lockCount},
+                {"contendedCount", contendedCount},
+                {"totalWait_us", totalWait_us},
+                {"maxWait_us", maxWait_us},
+            };
+        }
+
+        uint32_t lockCount = 0;
+        uint32_t contendedCount = 0;
+        uint64_t totalWait_us = 0;
+        uint32_t maxWait_us = 0;
+    };
+
+
     template<typename T, typename Lockable = std::mutex>
     class ValueMutex
     {
@@ -11,9 +33,9 @@ namespace Rtos
         class Lock
         {
         public:
-            Lock(T* value, Lockable& lockable) :
+            Lock(T* value, std::unique_lock<Lockable> lock) :
                 m_value(value),
-                m_lock(lockable)
+                m_lock(std::move(lock))
             {}
 
             inline T* get() const
@@ -44,11 +66,40 @@ namespace Rtos
 
         inline Lock get()
         {
-            return Lock(&m_value, m_lockable);
+            std::unique_lock<Lockable> lock(m_lockable, std::try_to_lock);
+            bool isContended = !lock.owns_lock();
+            uint32_t wait_us = 0;
+            if (isContended)
+            {
+                std::chrono::steady_clock::time_point waitStart = std::chrono::steady_clock::now();
+                lock.lock();
+                wait_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - waitStart
+                ).count();
+            }
+
+            std::lock_guard<std::mutex> statisticsLock(m_statisticsMutex);
+            m_waitStatistics.lockCount++;
+            if (isContended)
+                m_waitStatistics.contendedCount++;
+            m_waitStatistics.totalWait_us += wait_us;
+            if (wait_us > m_waitStatistics.maxWait_us)
+                m_waitStatistics.maxWait_us = wait_us;
+
+            return Lock(&m_value, std::move(lock));
+        }
+
+        // Does not wait for the value itself, so it can be polled while the value is locked
+        LockWaitStatistics getWaitStatistics() const
+        {
+            std::lock_guard<std::mutex> statisticsLock(m_statisticsMutex);
+            return m_waitStatistics;
         }
 
     private:
         Lockable m_lockable;
         T m_value;
+        mutable std::mutex m_statisticsMutex;
+        LockWaitStatistics m_waitStatistics;
     };
-}
\ No newline at end of file
+}
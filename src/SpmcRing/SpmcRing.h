@@ -0,0 +1,134 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+// Fixed capacity ring for one producer and any number of consumers. The producer never waits:
+// once the ring is full it overwrites the oldest entry. Every consumer reads at its own pace
+// through its own Cursor and skips ahead when it has fallen behind by more than the capacity.
+// Like SeqLock, values are held in atomic words, so a consumer copying a slot while it is overwritten is no data race.
+template<typename T, size_t Capacity>
+class SpmcRing
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity has to be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "SpmcRing can only hold trivially copyable values");
+
+public:
+    class Cursor
+    {
+    public:
+        explicit Cursor(uint32_t position = 0) noexcept : m_position(position)
+        {}
+
+        inline uint32_t getPosition() const noexcept
+        {
+            return m_position;
+        }
+
+        inline uint32_t getDroppedCount() const noexcept
+        {
+            return m_droppedCount;
+        }
+
+    private:
+        friend class SpmcRing;
+        uint32_t m_position;
+        uint32_t m_droppedCount = 0;
+    };
+
+
+    void push(const T& value) noexcept
+    {
+        uint32_t position = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[position % Capacity];
+        // An odd sequence marks the slot as being written
+        slot.sequence.store(position * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::array<uint32_t, wordCount> words = {};
+        memcpy(words.data(), &value, sizeof(T));
+        for (size_t i = 0; i < wordCount; i++)
+            slot.words[i].store(words[i], std::memory_order_relaxed);
+        slot.sequence.store(position * 2 + 2, std::memory_order_release);
+        m_head.store(position + 1, std::memory_order_release);
+    }
+
+
+    // Cursor that only sees values pushed from now on
+    Cursor getCursor() const noexcept
+    {
+        return Cursor(m_head.load(std::memory_order_acquire));
+    }
+
+
+    // Cursor that starts at the given position, clamped to the values still held by the ring.
+    // A position ahead of the head, e.g. from before a reboot, only sees values pushed from now on.
+    Cursor getCursor(uint32_t position) const noexcept
+    {
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        uint32_t heldCount = head < Capacity ? head : Capacity;
+        if (static_cast<int32_t>(position - head) > 0)
+            position = head;
+        else if (head - position > heldCount)
+            position = head - heldCount;
+        return Cursor(position);
+    }
+
+
+    bool pop(Cursor& cursor, T& value) const noexcept
+    {
+        while (true)
+        {
+            uint32_t head = m_head.load(std::memory_order_acquire);
+            if (cursor.m_position == head)
+                return false;
+
+            if (head - cursor.m_position > Capacity)
+            {
+                cursor.m_droppedCount += head - cursor.m_position - Capacity;
+                cursor.m_position = head - Capacity;
+            }
+
+            const Slot& slot = m_slots[cursor.m_position % Capacity];
+            uint32_t sequenceBefore = slot.sequence.load(std::memory_order_acquire);
+            if (sequenceBefore == cursor.m_position * 2 + 2)
+            {
+                std::array<uint32_t, wordCount> words;
+                for (size_t i = 0; i < wordCount; i++)
+                    words[i] = slot.words[i].load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == sequenceBefore)
+                {
+                    memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+                    cursor.m_position++;
+                    return true;
+                }
+            }
+
+            // The producer lapped this consumer while it was reading, so the value is lost
+            cursor.m_position++;
+            cursor.m_droppedCount++;
+        }
+    }
+
+
+    uint32_t getHeadPosition() const noexcept
+    {
+        return m_head.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_t wordCount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    struct Slot
+    {
+        std::atomic<uint32_t> sequence{0};
+        std::array<std::atomic<uint32_t>, wordCount> words;
+    };
+
+    Slot m_slots[Capacity];
+    std::atomic<uint32_t> m_head{0};
+};
@@ -2,6 +2,7 @@
 
 #include "Relay.h"
 #include "JsonResource/BasicJsonResource/BasicJsonResource.h"
+#include "JsonResource/CoalescingJsonResource/CoalescingJsonResource.h"
 #include "Filesystem/File/LittleFsFile/LittleFsFile.h"
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "Logger/Logger.h"
@@ -11,20 +12,26 @@
 
 namespace
 {
-    BasicJsonResource stateResource(
-        std::unique_ptr<Filesystem::File>(
-            new Filesystem::LittleFsFile("/Relay/State.json")
-        )
+    // Rapid toggling only writes the final state
+    CoalescingJsonResource stateResource(
+        std::unique_ptr<JsonResource>(
+            new BasicJsonResource(
+                std::unique_ptr<Filesystem::File>(
+                    new Filesystem::LittleFsFile("/Relay/State.json")
+                )
+            )
+        ),
+        std::chrono::milliseconds(2000)
     );
 }
 
 
-Relay::Relay(const json &configJson)
+Relay::Relay(const Config& config) :
+    m_pin(config.pin),
+    m_isNormallyOpen(config.isNormallyOpen)
 {
     try
     {
-        m_pin = configJson.at("pin");
-        m_isNormallyOpen = configJson.at("isNormallyOpen");
         bool state = stateResource.deserializeOr(false);
         pinMode(m_pin, OUTPUT);
         digitalWrite(m_pin,  m_isNormallyOpen ? state : !state);
@@ -6,7 +6,13 @@
 class Relay : public Switch
 {
 public:
-    Relay(const json& configJson);
+    struct Config
+    {
+        uint8_t pin;
+        bool isNormallyOpen;
+    };
+
+    Relay(const Config& config);
 
     tl::optional<bool> getState() const noexcept override;
     void setState(bool state) override;
@@ -14,4 +20,7 @@ public:
 private:
     uint8_t m_pin;
     bool m_isNormallyOpen;
-};
\ No newline at end of file
+};
+
+
+NLOHMANN_DEFINE_TYPE_NON_INTRUSIVE(Relay::Config, pin, isNormallyOpen)
\ No newline at end of file
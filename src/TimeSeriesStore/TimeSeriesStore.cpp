@@ -0,0 +1,450 @@
+#include "TimeSeriesStore.h"
+#include "Crc32/Crc32.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include "Logger/Logger.h"
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+namespace
+{
+    // Chunk file layout: 36 byte header followed by the payload of one GorillaChunk
+    constexpr uint8_t magic[4] = {'P', 'M', 'T', 'C'};
+    constexpr size_t headerSize = 36;
+    static_assert(headerSize + GorillaChunk::capacity_B <= TimeSeriesStore::chunkFileSize_B, "Chunk does not fit into a block");
+    const std::string chunkFileExtension = ".chunk";
+
+
+    // Sequence of a chunk file name, which is the sequence followed by the extension
+    tl::optional<uint32_t> parseChunkName(const std::string& name)
+    {
+        if (name.size() <= chunkFileExtension.size() || name.compare(name.size() - chunkFileExtension.size(), std::string::npos, chunkFileExtension) != 0)
+            return tl::nullopt;
+        std::string sequenceText = name.substr(0, name.size() - chunkFileExtension.size());
+        if (sequenceText.find_first_not_of("0123456789") != std::string::npos || sequenceText.size() > 10)
+            return tl::nullopt;
+        unsigned long long sequence = strtoull(sequenceText.c_str(), nullptr, 10);
+        if (sequence > UINT32_MAX)
+            return tl::nullopt;
+        return static_cast<uint32_t>(sequence);
+    }
+
+
+    void putUint16(uint8_t* bytes, uint16_t value) noexcept
+    {
+        bytes[0] = value;
+        bytes[1] = value >> 8;
+    }
+
+
+    void putUint32(uint8_t* bytes, uint32_t value) noexcept
+    {
+        for (size_t i = 0; i < 4; i++)
+            bytes[i] = value >> (i * 8);
+    }
+
+
+    void putInt64(uint8_t* bytes, int64_t value) noexcept
+    {
+        putUint32(bytes, static_cast<uint64_t>(value));
+        putUint32(bytes + 4, static_cast<uint64_t>(value) >> 32);
+    }
+
+
+    uint16_t getUint16(const uint8_t* bytes) noexcept
+    {
+        return bytes[0] | (bytes[1] << 8);
+    }
+
+
+    uint32_t getUint32(const uint8_t* bytes) noexcept
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+        return value;
+    }
+
+
+    int64_t getInt64(const uint8_t* bytes) noexcept
+    {
+        return static_cast<int64_t>(getUint32(bytes) | (static_cast<uint64_t>(getUint32(bytes + 4)) << 32));
+    }
+}
+
+
+json TimeSeriesStore::ChunkInfo::toJson() const
+{
+    return {
+        {"sequence", sequence},
+        {"firstTimestamp", firstTimestamp},
+        {"lastTimestamp", lastTimestamp},
+        {"count", count},
+        {"size_B", size_B},
+    };
+}
+
+
+TimeSeriesStore::TimeSeriesStore(std::unique_ptr<Filesystem::Directory> directory, FileFactory createFile, uint32_t maxChunkCount) noexcept :
+    m_directory(std::move(directory)),
+    m_createFile(std::move(createFile)),
+    m_maxChunkCount(maxChunkCount)
+{}
+
+
+bool TimeSeriesStore::append(int64_t timestamp, float value)
+{
+    try
+    {
+        open();
+        if (timestamp <= m_lastTimestamp)
+        {
+            m_rejectedCount++;
+            return false;
+        }
+
+        GorillaChunk::Point point = {timestamp, value};
+        if (!m_openChunk->append(point))
+        {
+            writeOpenChunk();
+            m_openSequence++;
+            m_openChunk->clear();
+            while (m_openSequence - m_oldestSequence >= m_maxChunkCount)
+            {
+                removeChunk(m_oldestSequence);
+                m_oldestSequence++;
+            }
+            if (!m_openChunk->append(point))
+            {
+                m_rejectedCount++;
+                return false;
+            }
+        }
+        m_lastTimestamp = timestamp;
+        m_isOpenChunkDirty = true;
+        return true;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to append to \"" + m_directory->getPath() + "\"");
+        throw;
+    }
+}
+
+
+void TimeSeriesStore::flush()
+{
+    try
+    {
+        if (!m_isOpened || !m_isOpenChunkDirty)
+            return;
+        writeOpenChunk();
+        m_isOpenChunkDirty = false;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to flush \"" + m_directory->getPath() + "\"");
+        throw;
+    }
+}
+
+
+size_t TimeSeriesStore::getChunkCount()
+{
+    open();
+    return m_openSequence - m_oldestSequence + (m_openChunk->isEmpty() ? 0 : 1);
+}
+
+
+TimeSeriesStore::ChunkInfo TimeSeriesStore::getChunkInfo(size_t index)
+{
+    if (index >= getChunkCount())
+        throw std::out_of_range(SOURCE_LOCATION + "Chunk index " + std::to_string(index) + " is out of range");
+
+    uint32_t sequence = m_oldestSequence + index;
+    if (sequence == m_openSequence)
+        return getOpenChunkInfo();
+    return getSealedChunkInfo(sequence);
+}
+
+
+std::vector<GorillaChunk::Point> TimeSeriesStore::readChunk(size_t index)
+{
+    try
+    {
+        if (index >= getChunkCount())
+            throw std::out_of_range(SOURCE_LOCATION + "Chunk index " + std::to_string(index) + " is out of range");
+
+        uint32_t sequence = m_oldestSequence + index;
+        if (sequence == m_openSequence)
+            return m_openChunk->decode();
+
+        std::unique_ptr<GorillaChunk> chunk(new GorillaChunk());
+        readSealedChunk(sequence, *chunk);
+        return chunk->decode();
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to read chunk " + std::to_string(index));
+        throw;
+    }
+}
+
+
+std::vector<GorillaChunk::Point> TimeSeriesStore::read(int64_t from, int64_t to, size_t maxCount)
+{
+    try
+    {
+        size_t chunkCount = getChunkCount();
+
+        // Chunks are ordered by time, so the first one reaching into the range is found by bisection
+        size_t low = 0;
+        size_t high = chunkCount;
+        while (low < high)
+        {
+            size_t middle = low + (high - low) / 2;
+            if (getChunkInfo(middle).lastTimestamp < from)
+                low = middle + 1;
+            else
+                high = middle;
+        }
+
+        std::vector<GorillaChunk::Point> points;
+        for (size_t index = low; index < chunkCount; index++)
+        {
+            if (getChunkInfo(index).firstTimestamp > to)
+                break;
+
+            for (const auto& point : readChunk(index))
+            {
+                if (point.timestamp >= from && point.timestamp <= to)
+                    points.push_back(point);
+                if (points.size() >= maxCount)
+                    return points;
+            }
+        }
+        return points;
+    }
+    catch (...)
+    {
+        std::stringstream errorMessage;
+        errorMessage << SOURCE_LOCATION << "Failed to read from " << from << " to " << to;
+        ExceptionTrace::trace(errorMessage.str());
+        throw;
+    }
+}
+
+
+json TimeSeriesStore::getStatistics()
+{
+    size_t chunkCount = getChunkCount();
+    json statisticsJson = {
+        {"maxChunkCount", m_maxChunkCount},
+        {"chunkCount", chunkCount},
+        {"openChunk", getOpenChunkInfo().toJson()},
+        {"rejectedCount", m_rejectedCount},
+    };
+    if (chunkCount > 0)
+    {
+        statisticsJson["firstTimestamp"] = getChunkInfo(0).firstTimestamp;
+        statisticsJson["lastTimestamp"] = m_lastTimestamp;
+    }
+    return statisticsJson;
+}
+
+
+void TimeSeriesStore::open()
+{
+    if (m_isOpened)
+        return;
+
+    if (m_maxChunkCount == 0)
+        throw std::runtime_error(SOURCE_LOCATION + "Maximum chunk count has to be greater than 0");
+
+    m_openChunk.reset(new GorillaChunk());
+    m_oldestSequence = 0;
+    m_openSequence = 0;
+    m_lastTimestamp = INT64_MIN;
+
+    std::vector<uint32_t> sequences;
+    try
+    {
+        for (const auto& entry : m_directory->getEntries())
+        {
+            tl::optional<uint32_t> sequence = parseChunkName(entry->getName());
+            if (sequence.has_value())
+                sequences.push_back(sequence.value());
+        }
+    }
+    catch (...)
+    {
+        // A missing directory is an empty store
+        ExceptionTrace::clear();
+    }
+    m_isOpened = true;
+
+    if (sequences.empty())
+        return;
+
+    uint32_t newestSequence = sequences.front();
+    for (uint32_t sequence : sequences)
+        newestSequence = sequence > newestSequence ? sequence : newestSequence;
+    m_oldestSequence = newestSequence;
+    for (uint32_t sequence : sequences)
+    {
+        if (sequence < m_oldestSequence && sequence + m_maxChunkCount > newestSequence)
+            m_oldestSequence = sequence;
+    }
+    // Left behind by a lower maximum chunk count or a power cut while removing them
+    for (uint32_t sequence : sequences)
+    {
+        if (sequence < m_oldestSequence)
+            removeChunk(sequence);
+    }
+
+    // The newest chunk might not be full yet, so it is continued
+    m_openSequence = newestSequence;
+    try
+    {
+        readSealedChunk(newestSequence, *m_openChunk);
+        m_lastTimestamp = m_openChunk->getLastTimestamp();
+    }
+    catch (...)
+    {
+        Logger[LogLevel::Warning] << "Dropping corrupted chunk of \"" << m_directory->getPath() << "\":\n" << ExceptionTrace::what() << std::endl;
+        m_openChunk->clear();
+        if (m_openSequence == m_oldestSequence)
+            return;
+        try
+        {
+            m_lastTimestamp = getSealedChunkInfo(m_openSequence - 1).lastTimestamp;
+        }
+        catch (...)
+        {
+            ExceptionTrace::clear();
+        }
+    }
+}
+
+
+std::string TimeSeriesStore::getChunkPath(uint32_t sequence) const
+{
+    return m_directory->getPath() + '/' + std::to_string(sequence) + chunkFileExtension;
+}
+
+
+tl::optional<TimeSeriesStore::ChunkInfo> TimeSeriesStore::readChunkHeader(std::iostream& stream, uint32_t sequence, uint32_t& payloadCrc, size_t& bitCount)
+{
+    uint8_t header[headerSize];
+    stream.read(reinterpret_cast<char*>(header), headerSize);
+    if (stream.gcount() != headerSize)
+        return tl::nullopt;
+
+    if (memcmp(header, magic, sizeof(magic)) != 0 || getUint32(header + 32) != Crc32::calculate(header, 32))
+        return tl::nullopt;
+
+    ChunkInfo chunkInfo;
+    chunkInfo.sequence = getUint32(header + 4);
+    chunkInfo.firstTimestamp = getInt64(header + 8);
+    chunkInfo.lastTimestamp = getInt64(header + 16);
+    chunkInfo.count = getUint16(header + 24);
+    bitCount = getUint16(header + 26);
+    chunkInfo.size_B = (bitCount + 7) / 8;
+    payloadCrc = getUint32(header + 28);
+
+    if (chunkInfo.sequence != sequence || chunkInfo.size_B > GorillaChunk::capacity_B)
+        return tl::nullopt;
+    return chunkInfo;
+}
+
+
+TimeSeriesStore::ChunkInfo TimeSeriesStore::getSealedChunkInfo(uint32_t sequence)
+{
+    std::unique_ptr<Filesystem::File> file = m_createFile(getChunkPath(sequence));
+    Filesystem::File::Stream stream = file->open(std::ios::in | std::ios::binary);
+    uint32_t payloadCrc;
+    size_t bitCount;
+    tl::optional<ChunkInfo> chunkInfo = readChunkHeader(*stream, sequence, payloadCrc, bitCount);
+    if (!chunkInfo.has_value())
+        throw std::runtime_error(SOURCE_LOCATION + "Chunk " + std::to_string(sequence) + " is corrupted");
+    return chunkInfo.value();
+}
+
+
+void TimeSeriesStore::readSealedChunk(uint32_t sequence, GorillaChunk& chunk)
+{
+    std::unique_ptr<Filesystem::File> file = m_createFile(getChunkPath(sequence));
+    Filesystem::File::Stream stream = file->open(std::ios::in | std::ios::binary);
+    uint32_t payloadCrc;
+    size_t bitCount;
+    tl::optional<ChunkInfo> chunkInfo = readChunkHeader(*stream, sequence, payloadCrc, bitCount);
+    if (!chunkInfo.has_value())
+        throw std::runtime_error(SOURCE_LOCATION + "Chunk " + std::to_string(sequence) + " is corrupted");
+
+    std::vector<uint8_t> payload(chunkInfo->size_B);
+    stream->read(reinterpret_cast<char*>(payload.data()), payload.size());
+    if (
+        static_cast<size_t>(stream->gcount()) != payload.size() ||
+        Crc32::calculate(payload.data(), payload.size()) != payloadCrc ||
+        !chunk.load(payload.data(), bitCount, chunkInfo->count)
+    )
+        throw std::runtime_error(SOURCE_LOCATION + "Payload of chunk " + std::to_string(sequence) + " is corrupted");
+}
+
+
+void TimeSeriesStore::writeOpenChunk()
+{
+    if (m_openChunk->isEmpty())
+        return;
+
+    std::vector<uint8_t> content(headerSize + m_openChunk->getSize_B());
+    memcpy(content.data(), magic, sizeof(magic));
+    putUint32(&content[4], m_openSequence);
+    putInt64(&content[8], m_openChunk->getFirstTimestamp());
+    putInt64(&content[16], m_openChunk->getLastTimestamp());
+    putUint16(&content[24], m_openChunk->getCount());
+    putUint16(&content[26], m_openChunk->getBitCount());
+    putUint32(&content[28], Crc32::calculate(m_openChunk->getData(), m_openChunk->getSize_B()));
+    putUint32(&content[32], Crc32::calculate(content.data(), 32));
+    memcpy(&content[headerSize], m_openChunk->getData(), m_openChunk->getSize_B());
+
+    std::unique_ptr<Filesystem::File> file = m_createFile(getChunkPath(m_openSequence));
+    Filesystem::File::Stream stream = file->open(std::ios::out | std::ios::trunc | std::ios::binary);
+    stream->write(reinterpret_cast<const char*>(content.data()), content.size());
+    stream->flush();
+    if (!stream->good())
+        throw std::runtime_error(SOURCE_LOCATION + "Failed to write chunk " + std::to_string(m_openSequence));
+}
+
+
+void TimeSeriesStore::removeChunk(uint32_t sequence) noexcept
+{
+    try
+    {
+        std::unique_ptr<Filesystem::File> file = m_createFile(getChunkPath(sequence));
+        if (file->exists())
+            file->remove();
+    }
+    catch (...)
+    {
+        // Removed again when the store is opened the next time
+        Logger[LogLevel::Warning] << "Failed to remove chunk " << sequence << " of \"" << m_directory->getPath() << "\"" << std::endl;
+        ExceptionTrace::clear();
+    }
+}
+
+
+TimeSeriesStore::ChunkInfo TimeSeriesStore::getOpenChunkInfo() const noexcept
+{
+    ChunkInfo chunkInfo;
+    chunkInfo.sequence = m_openSequence;
+    chunkInfo.firstTimestamp = m_openChunk ? m_openChunk->getFirstTimestamp() : 0;
+    chunkInfo.lastTimestamp = m_openChunk ? m_openChunk->getLastTimestamp() : 0;
+    chunkInfo.count = m_openChunk ? m_openChunk->getCount() : 0;
+    chunkInfo.size_B = m_openChunk ? m_openChunk->getSize_B() : 0;
+    return chunkInfo;
+}
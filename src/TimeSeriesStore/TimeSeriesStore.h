@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GorillaChunk/GorillaChunk.h"
+#include "Filesystem/Directory/Directory.h"
+#include "Filesystem/File/File.h"
+#include <json.hpp>
+#include <tl/optional.hpp>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Long term history of one value, compressed into GorillaChunks which are kept in one file per chunk. Appending
+// only touches the open chunk in RAM, which is written to its file when it is full or on flush(). Once the
+// maximum count of chunks is reached, the file of the oldest chunk is removed before a new one is started.
+// Every write replaces a whole file of at most one block, so the filesystem never copies more than that.
+// A power cut loses the points appended since the last flush.
+class TimeSeriesStore
+{
+public:
+    // Upper bound of the size of a chunk file, which is one block of LittleFS
+    static constexpr size_t chunkFileSize_B = 4096;
+    using FileFactory = std::function<std::unique_ptr<Filesystem::File>(const std::string& path)>;
+
+    struct ChunkInfo
+    {
+        json toJson() const;
+        uint32_t sequence;
+        int64_t firstTimestamp;
+        int64_t lastTimestamp;
+        size_t count;
+        size_t size_B;
+    };
+
+    // Chunk files are listed from the directory and created by the factory, with a path inside of it
+    TimeSeriesStore(std::unique_ptr<Filesystem::Directory> directory, FileFactory createFile, uint32_t maxChunkCount) noexcept;
+    // Rejects, and counts, points which are not newer than the last one
+    bool append(int64_t timestamp, float value);
+    void flush();
+    size_t getChunkCount();
+    ChunkInfo getChunkInfo(size_t index);
+    std::vector<GorillaChunk::Point> readChunk(size_t index);
+    std::vector<GorillaChunk::Point> read(int64_t from, int64_t to, size_t maxCount = SIZE_MAX);
+    json getStatistics();
+
+private:
+    void open();
+    std::string getChunkPath(uint32_t sequence) const;
+    tl::optional<ChunkInfo> readChunkHeader(std::iostream& stream, uint32_t sequence, uint32_t& payloadCrc, size_t& bitCount);
+    ChunkInfo getSealedChunkInfo(uint32_t sequence);
+    void readSealedChunk(uint32_t sequence, GorillaChunk& chunk);
+    void writeOpenChunk();
+    void removeChunk(uint32_t sequence) noexcept;
+    ChunkInfo getOpenChunkInfo() const noexcept;
+
+    std::unique_ptr<Filesystem::Directory> m_directory;
+    FileFactory m_createFile;
+    uint32_t m_maxChunkCount;
+    bool m_isOpened = false;
+    uint32_t m_oldestSequence = 0;
+    uint32_t m_openSequence = 0;
+    std::unique_ptr<GorillaChunk> m_openChunk;
+    bool m_isOpenChunkDirty = false;
+    int64_t m_lastTimestamp = INT64_MIN;
+    uint32_t m_rejectedCount = 0;   // Points which were not newer than the last one, since boot
+};
@@ -12,23 +12,25 @@ Tracker::Tracker(
     time_t duration_s,
     size_t sampleCount,
     const Clock* clock,
-    std::unique_ptr<JsonResource> dataResource,
+    std::unique_ptr<TrackerStore> dataStore,
     std::unique_ptr<JsonResource> lastInputResource,
     std::unique_ptr<JsonResource> lastSampleResource,
-    AverageAccumulator accumulator
+    AverageAccumulator accumulator,
+    CheckpointPolicy checkpointPolicy
 ) noexcept :
     m_title(std::move(title)),
     m_duration_s(duration_s),
     m_sampleCount(sampleCount),
     m_clock(clock),
-    m_dataResource(std::move(dataResource)),
+    m_dataStore(std::move(dataStore)),
     m_lastInputResource(std::move(lastInputResource)),
     m_lastSampleResource(std::move(lastSampleResource)),
-    m_accumulator(std::move(accumulator))
+    m_accumulator(std::move(accumulator)),
+    m_checkpointPolicy(checkpointPolicy)
 {}
 
 
-void Tracker::track(float value)
+tl::optional<float> Tracker::track(float value)
 {
     try
     {
@@ -36,14 +38,13 @@ void Tracker::track(float value)
             value = 0.0f;
 
         time_t now = m_clock->now();
-        time_t lastInputTimestamp = getTimestamp(*m_lastInputResource);
-        time_t secondsSinceLastInput = now - lastInputTimestamp;
+        if (!m_lastInputTimestamp.has_value())
+            m_lastInputTimestamp = getTimestamp(*m_lastInputResource);
+        time_t secondsSinceLastInput = now - m_lastInputTimestamp.value();
 
-        if(secondsSinceLastInput <= 0)
-            lastInputTimestamp = now;
-
-        m_lastInputResource->serialize(now);
+        m_lastInputTimestamp = now;
         m_accumulator.add(value, secondsSinceLastInput);
+        m_unsavedInputCount++;
 
         time_t lastSampleTimestamp = getTimestamp(*m_lastSampleResource);
         uint32_t timesElapsed = (now - lastSampleTimestamp) / (m_duration_s / m_sampleCount);
@@ -54,11 +55,24 @@ void Tracker::track(float value)
             if (timesElapsed > m_sampleCount)
                 timesElapsed = m_sampleCount;
 
+            float average = m_accumulator.getAverage();
             std::vector<float> newValues(timesElapsed - 1, NAN); // Fill values with null while PowerMeter was off
-            newValues.push_back(m_accumulator.getAverage());
+            newValues.push_back(average);
             updateData(newValues);
             m_accumulator.reset();
+            // The reset has to reach flash together with the new sample, otherwise it is counted twice after a reboot
+            checkpoint();
+            return average;
+        }
+
+        if (
+            now - m_lastCheckpointTimestamp >= m_checkpointPolicy.interval_s ||
+            m_unsavedInputCount >= m_checkpointPolicy.maxUnsavedInputCount
+        )
+        {
+            checkpoint();
         }
+        return tl::nullopt;
     }
     catch(...)
     {
@@ -78,7 +92,7 @@ json Tracker::getData() const
         data["title"] = m_title;
         data["sampleCount"] = m_sampleCount;
         data["duration_s"] = m_duration_s;
-        data["data"] = m_dataResource->deserializeOr(json());
+        data["data"] = m_dataStore->getData();
         return data;
     }
     catch(...)
@@ -93,7 +107,7 @@ void Tracker::setData(const json& data)
 {
     try
     {
-        m_dataResource->serialize(data.at("data"));
+        m_dataStore->setData(data.at("data"));
     }
     catch(...)
     {
@@ -105,36 +119,81 @@ void Tracker::setData(const json& data)
 
 void Tracker::erase()
 {
-    m_dataResource->remove();
+    m_dataStore->remove();
     m_lastInputResource->remove();
     m_lastSampleResource->remove();
     m_accumulator.remove();
+    m_lastInputTimestamp = tl::nullopt;
+    m_unsavedInputCount = 0;
 }
 
 
-void Tracker::updateData(const std::vector<float>& newValues)
+void Tracker::checkpoint()
 {
     try
     {
-        json values = m_dataResource->deserializeOr(json::array_t());
+        if (m_unsavedInputCount > 0 && m_lastInputTimestamp.has_value())
+            m_lastInputResource->serialize(m_lastInputTimestamp.value());
+        m_accumulator.checkpoint();
+        m_lastCheckpointTimestamp = m_clock->now();
+        m_unsavedInputCount = 0;
+    }
+    catch(...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to checkpoint \"" + m_title + "\"");
+        throw;
+    }
+}
 
-        for (const auto& value : newValues)
-        {
-            if (isfinite(value))
-                values.push_back(value);
-            else
-                values.push_back(nullptr);
-        }
 
-        if(values.size() > m_sampleCount)
-            values.erase(values.begin(), values.begin() + values.size() - m_sampleCount);
+void Tracker::setCheckpointPolicy(CheckpointPolicy checkpointPolicy) noexcept
+{
+    m_checkpointPolicy = checkpointPolicy;
+}
+
+
+time_t Tracker::getSampleDuration_s() const noexcept
+{
+    return m_duration_s / m_sampleCount;
+}
+
+
+void Tracker::cascadeTo(std::string trackerId)
+{
+    m_cascadeTargetIds.push_back(std::move(trackerId));
+}
 
-        if (values.size() > m_sampleCount)
-        {
-            throw std::runtime_error(SOURCE_LOCATION + "Too many values");
-        }
 
-        m_dataResource->serialize(values);
+void Tracker::clearCascade() noexcept
+{
+    m_cascadeTargetIds.clear();
+    m_isCascaded = false;
+}
+
+
+const std::vector<std::string>& Tracker::getCascadeTargetIds() const noexcept
+{
+    return m_cascadeTargetIds;
+}
+
+
+void Tracker::setCascaded(bool isCascaded) noexcept
+{
+    m_isCascaded = isCascaded;
+}
+
+
+bool Tracker::isCascaded() const noexcept
+{
+    return m_isCascaded;
+}
+
+
+void Tracker::updateData(const std::vector<float>& newValues)
+{
+    try
+    {
+        m_dataStore->append(newValues, m_clock->now());
         m_lastSampleResource->serialize(m_clock->now());
     }
     catch(...)
@@ -157,4 +216,13 @@ time_t Tracker::getTimestamp(JsonResource& timestampResource) const
         timestampResource.serialize(m_clock->now());
         return m_clock->now();
     }
-}
\ No newline at end of file
+}
+
+
+json getTrackersData(const TrackerMap& trackers)
+{
+    json trackersJson = json::object_t();
+    for (const auto& tracker : trackers)
+        trackersJson[tracker.first] = tracker.second.getData();
+    return trackersJson;
+}
@@ -2,27 +2,48 @@
 
 #include "Clock/Clock.h"
 #include "JsonResource/JsonResource.h"
+#include "TrackerStore/TrackerStore.h"
 #include "AverageAccumulator/AverageAccumulator.h"
+#include <tl/optional.hpp>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
+// The accumulator and the timestamp of the last input are kept in RAM and written to flash once the
+// checkpoint policy is due and whenever a sample closes. On a power cut, the inputs since the last checkpoint
+// are lost, which is at most checkpointInterval_s seconds or maxUnsavedInputCount inputs.
 class Tracker
 {
 public:
+    struct CheckpointPolicy
+    {
+        time_t interval_s;
+        size_t maxUnsavedInputCount;
+    };
+
     Tracker(
         std::string title,
         time_t duration_s,
         size_t sampleCount,
         const Clock* clock,
-        std::unique_ptr<JsonResource> dataResource,
+        std::unique_ptr<TrackerStore> dataStore,
         std::unique_ptr<JsonResource> lastInputResource,
         std::unique_ptr<JsonResource> lastSampleResource,
-        AverageAccumulator accumulator
+        AverageAccumulator accumulator,
+        CheckpointPolicy checkpointPolicy = {0, 0}
     ) noexcept;
-    void track(float value);
+    tl::optional<float> track(float value);
     json getData() const;
     void setData(const json& data);
     void erase();
+    void checkpoint();
+    void setCheckpointPolicy(CheckpointPolicy checkpointPolicy) noexcept;
+    time_t getSampleDuration_s() const noexcept;
+    void cascadeTo(std::string trackerId);
+    void clearCascade() noexcept;
+    const std::vector<std::string>& getCascadeTargetIds() const noexcept;
+    void setCascaded(bool isCascaded) noexcept;
+    bool isCascaded() const noexcept;
 
 private:
     void updateData(const std::vector<float>& newValues);
@@ -32,10 +53,18 @@ private:
     time_t m_duration_s;
     size_t m_sampleCount;
     const Clock* m_clock;
-    std::unique_ptr<JsonResource> m_dataResource;
+    std::unique_ptr<TrackerStore> m_dataStore;
     std::unique_ptr<JsonResource> m_lastInputResource;
     std::unique_ptr<JsonResource> m_lastSampleResource;
     AverageAccumulator m_accumulator;
+    CheckpointPolicy m_checkpointPolicy;
+    tl::optional<time_t> m_lastInputTimestamp;
+    time_t m_lastCheckpointTimestamp = 0;
+    size_t m_unsavedInputCount = 0;
+    std::vector<std::string> m_cascadeTargetIds;
+    bool m_isCascaded = false;
 };
 
-using TrackerMap = std::unordered_map<std::string, Tracker>;
\ No newline at end of file
+using TrackerMap = std::unordered_map<std::string, Tracker>;
+
+json getTrackersData(const TrackerMap& trackers);
@@ -0,0 +1,71 @@
+#include "TrackerCascade.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+
+namespace
+{
+    bool trackAndPropagate(TrackerMap& trackers, Tracker& tracker, float value)
+    {
+        tl::optional<float> closedSample = tracker.track(value);
+        if (!closedSample.has_value())
+            return false;
+
+        for (const auto& targetId : tracker.getCascadeTargetIds())
+            trackAndPropagate(trackers, trackers.at(targetId), closedSample.value());
+        return true;
+    }
+}
+
+
+void TrackerCascade::build(TrackerMap& trackers)
+{
+    try
+    {
+        // Rebuilt from scratch, whenever trackers were added or removed
+        for (auto& tracker : trackers)
+            tracker.second.clearCascade();
+
+        for (auto& target : trackers)
+        {
+            time_t targetDuration_s = target.second.getSampleDuration_s();
+            TrackerMap::iterator source = trackers.end();
+            for (TrackerMap::iterator candidate = trackers.begin(); candidate != trackers.end(); candidate++)
+            {
+                time_t candidateDuration_s = candidate->second.getSampleDuration_s();
+                if (candidateDuration_s <= 0 || candidateDuration_s >= targetDuration_s || targetDuration_s % candidateDuration_s != 0)
+                    continue;
+
+                // Prefer the coarsest source, ties are resolved by ID to stay independent of the map order
+                if (
+                    source == trackers.end() ||
+                    candidateDuration_s > source->second.getSampleDuration_s() ||
+                    (candidateDuration_s == source->second.getSampleDuration_s() && candidate->first < source->first)
+                )
+                    source = candidate;
+            }
+
+            if (source != trackers.end())
+            {
+                source->second.cascadeTo(target.first);
+                target.second.setCascaded(true);
+            }
+        }
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to build tracker cascade");
+        throw;
+    }
+}
+
+
+bool TrackerCascade::track(TrackerMap& trackers, float value)
+{
+    bool hasClosedSample = false;
+    for (auto& tracker : trackers)
+    {
+        if (!tracker.second.isCascaded() && trackAndPropagate(trackers, tracker.second, value))
+            hasClosedSample = true;
+    }
+    return hasClosedSample;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "Tracker/Tracker.h"
+
+// Lets finer trackers feed their closed samples into coarser ones instead of every tracker
+// accumulating every input. Each tracker is fed by the next finer tracker whose sample duration
+// divides its own, so long horizons are built from exactly the values the short ones show.
+namespace TrackerCascade
+{
+    void build(TrackerMap& trackers);
+    // Returns whether any tracker closed a sample
+    bool track(TrackerMap& trackers, float value);
+}
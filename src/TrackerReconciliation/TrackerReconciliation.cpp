@@ -0,0 +1,70 @@
+#include "TrackerReconciliation.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include <utility>
+
+
+TrackerReconciliation::Plan TrackerReconciliation::plan(const json& currentTrackersJson, const json& trackersJson)
+{
+    try
+    {
+        Plan plan;
+        for (const auto& trackerJson : trackersJson.items())
+        {
+            json::const_iterator currentTrackerJson = currentTrackersJson.find(trackerJson.key());
+            if (currentTrackerJson == currentTrackersJson.end())
+                plan.createdIds.push_back(trackerJson.key());
+            else if (*currentTrackerJson != trackerJson.value())
+                plan.replacedIds.push_back(trackerJson.key());
+            else
+                plan.keptIds.push_back(trackerJson.key());
+        }
+        for (const auto& currentTrackerJson : currentTrackersJson.items())
+        {
+            if (!trackersJson.contains(currentTrackerJson.key()))
+                plan.removedIds.push_back(currentTrackerJson.key());
+        }
+        return plan;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to plan tracker reconciliation");
+        throw;
+    }
+}
+
+
+TrackerMap TrackerReconciliation::apply(TrackerMap& trackers, const Plan& plan, TrackerMap preparedTrackers)
+{
+    try
+    {
+        // The only step writing to flash, the map is still untouched if it fails
+        for (const auto& trackerId : plan.replacedIds)
+        {
+            TrackerMap::iterator tracker = trackers.find(trackerId);
+            if (tracker != trackers.end())
+                tracker->second.checkpoint();
+        }
+
+        TrackerMap removedTrackers;
+        for (const auto& trackerId : plan.removedIds)
+        {
+            TrackerMap::iterator tracker = trackers.find(trackerId);
+            if (tracker == trackers.end())
+                continue;
+            removedTrackers.insert(std::make_pair(tracker->first, std::move(tracker->second)));
+            trackers.erase(tracker);
+        }
+        for (auto& preparedTracker : preparedTrackers)
+        {
+            trackers.erase(preparedTracker.first);
+            trackers.insert(std::make_pair(preparedTracker.first, std::move(preparedTracker.second)));
+        }
+        return removedTrackers;
+    }
+    catch (...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to apply tracker reconciliation");
+        throw;
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Tracker/Tracker.h"
+#include <string>
+#include <vector>
+
+// Works out, which trackers a config change touches, so trackers with an unchanged entry keep their
+// object and the inputs cached in RAM. The new trackers are built before any running one is touched,
+// so a failure while building them leaves the map as it was.
+namespace TrackerReconciliation
+{
+    struct Plan
+    {
+        // Not configured before
+        std::vector<std::string> createdIds;
+        // Configured with a different entry, the replacement continues from what is on flash
+        std::vector<std::string> replacedIds;
+        std::vector<std::string> keptIds;
+        // Not configured anymore
+        std::vector<std::string> removedIds;
+    };
+
+    Plan plan(const json& currentTrackersJson, const json& trackersJson);
+    // Swaps the prepared trackers in and hands back the removed ones, whose files are left to be erased
+    TrackerMap apply(TrackerMap& trackers, const Plan& plan, TrackerMap preparedTrackers);
+}
\ No newline at end of file
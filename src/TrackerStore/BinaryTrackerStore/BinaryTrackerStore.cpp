@@ -0,0 +1,339 @@
+#include "BinaryTrackerStore.h"
+#include "Crc32/Crc32.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include <math.h>
+#include <string.h>
+#include <utility>
+
+namespace
+{
+    // File layout: two header copies followed by capacity + 1 records of one little endian float each.
+    // The spare record is the one being written, so a torn write never touches a value the previous header covers.
+    constexpr uint8_t magic[4] = {'P', 'M', 'T', 'S'};
+    constexpr uint16_t formatVersion = 1;
+    constexpr size_t recordSize = 4;
+    constexpr size_t headerSize = 36;
+    constexpr size_t headerCopyCount = 2;
+    constexpr size_t recordsOffset = headerSize * headerCopyCount;
+
+
+    void putUint16(uint8_t* bytes, uint16_t value) noexcept
+    {
+        bytes[0] = value;
+        bytes[1] = value >> 8;
+    }
+
+
+    void putUint32(uint8_t* bytes, uint32_t value) noexcept
+    {
+        for (size_t i = 0; i < 4; i++)
+            bytes[i] = value >> (i * 8);
+    }
+
+
+    uint16_t getUint16(const uint8_t* bytes) noexcept
+    {
+        return bytes[0] | (bytes[1] << 8);
+    }
+
+
+    uint32_t getUint32(const uint8_t* bytes) noexcept
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < 4; i++)
+            value |= static_cast<uint32_t>(bytes[i]) << (i * 8);
+        return value;
+    }
+
+
+    void putFloat(uint8_t* bytes, float value) noexcept
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        putUint32(bytes, bits);
+    }
+
+
+    float getFloat(const uint8_t* bytes) noexcept
+    {
+        uint32_t bits = getUint32(bytes);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+
+    std::streamoff getRecordOffset(uint32_t index) noexcept
+    {
+        return recordsOffset + static_cast<std::streamoff>(index) * recordSize;
+    }
+
+
+    uint32_t getSlotCount(uint32_t capacity) noexcept
+    {
+        return capacity + 1;
+    }
+
+
+    void checkStream(const std::iostream& stream, const std::string& action)
+    {
+        if (!stream.good())
+            throw std::runtime_error(SOURCE_LOCATION + "Failed to " + action);
+    }
+}
+
+
+BinaryTrackerStore::BinaryTrackerStore(std::unique_ptr<Filesystem::File> file, size_t sampleCount) noexcept :
+    m_file(std::move(file)),
+    m_sampleCount(sampleCount)
+{}
+
+
+json BinaryTrackerStore::getData()
+{
+    try
+    {
+        const tl::optional<Header>& header = getHeader();
+        if (!header.has_value() || header->count == 0)
+            return json();
+
+        json data = json::array_t();
+        for (float value : readValues(*header))
+        {
+            if (isfinite(value))
+                data.push_back(value);
+            else
+                data.push_back(nullptr);
+        }
+        return data;
+    }
+    catch(...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to get data from \"" + m_file->getPath() + "\"");
+        throw;
+    }
+}
+
+
+void BinaryTrackerStore::setData(const json& data)
+{
+    try
+    {
+        if (!data.is_array())
+            throw std::runtime_error(SOURCE_LOCATION + "Tracker data has to be an array");
+
+        std::vector<float> values;
+        values.reserve(data.size());
+        for (const auto& value : data)
+            values.push_back(value.is_number() ? value.get<float>() : NAN);
+
+        const tl::optional<Header>& header = getHeader();
+        initialize(values, header.has_value() ? header->epoch : 0);
+    }
+    catch(...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to set data of \"" + m_file->getPath() + "\"");
+        throw;
+    }
+}
+
+
+void BinaryTrackerStore::append(const std::vector<float>& values, time_t timestamp)
+{
+    try
+    {
+        tl::optional<Header>& cachedHeader = getHeader();
+        if (!cachedHeader.has_value())
+        {
+            initialize(values, timestamp);
+            return;
+        }
+
+        Header header = *cachedHeader;
+        // Values that would be overwritten within this call anyway are skipped
+        size_t firstIndex = values.size() > header.capacity ? values.size() - header.capacity : 0;
+
+        Filesystem::File::Stream stream = m_file->open(std::ios::in | std::ios::out | std::ios::binary);
+        stream->seekp(getRecordOffset(header.head));
+        for (size_t i = firstIndex; i < values.size(); i++)
+        {
+            if (header.head == 0)
+                stream->seekp(getRecordOffset(0));
+
+            uint8_t record[recordSize];
+            putFloat(record, values[i]);
+            stream->write(reinterpret_cast<const char*>(record), recordSize);
+
+            header.head = (header.head + 1) % getSlotCount(header.capacity);
+            if (header.count < header.capacity)
+                header.count++;
+        }
+        checkStream(*stream, "write records");
+
+        header.sequence++;
+        header.epoch = timestamp;
+        writeHeader(*stream, header);
+        cachedHeader = header;
+    }
+    catch(...)
+    {
+        m_isHeaderLoaded = false;
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to append " + json(values).dump() + " to \"" + m_file->getPath() + "\"");
+        throw;
+    }
+}
+
+
+void BinaryTrackerStore::remove()
+{
+    try
+    {
+        if (m_file->exists())
+            m_file->remove();
+        m_header = tl::nullopt;
+        m_isHeaderLoaded = true;
+    }
+    catch(...)
+    {
+        m_isHeaderLoaded = false;
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to remove \"" + m_file->getPath() + "\"");
+        throw;
+    }
+}
+
+
+tl::optional<time_t> BinaryTrackerStore::getEpoch()
+{
+    const tl::optional<Header>& header = getHeader();
+    if (!header.has_value())
+        return tl::nullopt;
+    return static_cast<time_t>(header->epoch);
+}
+
+
+tl::optional<BinaryTrackerStore::Header>& BinaryTrackerStore::getHeader()
+{
+    if (m_isHeaderLoaded)
+        return m_header;
+
+    m_header = tl::nullopt;
+    m_isHeaderLoaded = true;
+    uint8_t bytes[headerSize * headerCopyCount];
+    try
+    {
+        Filesystem::File::Stream stream = m_file->open(std::ios::in | std::ios::binary);
+        stream->read(reinterpret_cast<char*>(bytes), sizeof(bytes));
+        if (stream->gcount() != sizeof(bytes))
+            return m_header;
+    }
+    catch(...)
+    {
+        // A missing file is an empty store
+        ExceptionTrace::clear();
+        return m_header;
+    }
+
+    for (size_t copy = 0; copy < headerCopyCount; copy++)
+    {
+        const uint8_t* headerBytes = bytes + copy * headerSize;
+        if (memcmp(headerBytes, magic, sizeof(magic)) != 0 ||
+            getUint16(headerBytes + 4) != formatVersion ||
+            getUint16(headerBytes + 6) != recordSize ||
+            getUint32(headerBytes + 32) != Crc32::calculate(headerBytes, 32))
+            continue;
+
+        Header header;
+        header.capacity = getUint32(headerBytes + 8);
+        header.head = getUint32(headerBytes + 12);
+        header.count = getUint32(headerBytes + 16);
+        header.sequence = getUint32(headerBytes + 20);
+        header.epoch = static_cast<int64_t>(getUint32(headerBytes + 24)) |
+            (static_cast<int64_t>(getUint32(headerBytes + 28)) << 32);
+
+        if (header.capacity == 0 || header.head >= getSlotCount(header.capacity) || header.count > header.capacity)
+            continue;
+
+        if (!m_header.has_value() || static_cast<int32_t>(header.sequence - m_header->sequence) > 0)
+            m_header = header;
+    }
+
+    // The sample count has been reconfigured, keep the newest values
+    if (m_header.has_value() && m_header->capacity != m_sampleCount)
+        initialize(readValues(*m_header), m_header->epoch);
+
+    return m_header;
+}
+
+
+std::vector<float> BinaryTrackerStore::readValues(const Header& header)
+{
+    uint32_t slotCount = getSlotCount(header.capacity);
+    std::vector<uint8_t> records(slotCount * recordSize);
+    Filesystem::File::Stream stream = m_file->open(std::ios::in | std::ios::binary);
+    stream->seekg(getRecordOffset(0));
+    stream->read(reinterpret_cast<char*>(records.data()), records.size());
+    if (static_cast<size_t>(stream->gcount()) != records.size())
+        throw std::runtime_error(SOURCE_LOCATION + "Records of \"" + m_file->getPath() + "\" are truncated");
+
+    std::vector<float> values;
+    values.reserve(header.count);
+    uint32_t index = (header.head + slotCount - header.count) % slotCount;
+    for (uint32_t i = 0; i < header.count; i++)
+    {
+        values.push_back(getFloat(&records[index * recordSize]));
+        index = (index + 1) % slotCount;
+    }
+    return values;
+}
+
+
+void BinaryTrackerStore::initialize(const std::vector<float>& values, time_t epoch)
+{
+    if (m_sampleCount == 0)
+        throw std::runtime_error(SOURCE_LOCATION + "Sample count has to be greater than 0");
+
+    Header header;
+    header.capacity = m_sampleCount;
+    header.count = values.size() > m_sampleCount ? m_sampleCount : values.size();
+    header.head = header.count;
+    header.sequence = m_header.has_value() ? m_header->sequence + 1 : 0;
+    header.epoch = epoch;
+
+    // Written in one go, unused records are filled with NaN
+    std::vector<uint8_t> bytes(recordsOffset + getSlotCount(header.capacity) * recordSize, 0);
+    for (uint32_t i = 0; i < getSlotCount(header.capacity); i++)
+    {
+        float value = i < header.count ? values[values.size() - header.count + i] : NAN;
+        putFloat(&bytes[getRecordOffset(i)], value);
+    }
+
+    m_isHeaderLoaded = false;
+    Filesystem::File::Stream stream = m_file->open(std::ios::out | std::ios::trunc | std::ios::binary);
+    stream->write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    checkStream(*stream, "write records");
+    writeHeader(*stream, header);
+    m_header = header;
+    m_isHeaderLoaded = true;
+}
+
+
+void BinaryTrackerStore::writeHeader(std::iostream& stream, const Header& header)
+{
+    uint8_t bytes[headerSize];
+    memcpy(bytes, magic, sizeof(magic));
+    putUint16(bytes + 4, formatVersion);
+    putUint16(bytes + 6, recordSize);
+    putUint32(bytes + 8, header.capacity);
+    putUint32(bytes + 12, header.head);
+    putUint32(bytes + 16, header.count);
+    putUint32(bytes + 20, header.sequence);
+    putUint32(bytes + 24, static_cast<uint64_t>(header.epoch));
+    putUint32(bytes + 28, static_cast<uint64_t>(header.epoch) >> 32);
+    putUint32(bytes + 32, Crc32::calculate(bytes, 32));
+
+    stream.seekp((header.sequence % headerCopyCount) * headerSize);
+    stream.write(reinterpret_cast<const char*>(bytes), sizeof(bytes));
+    stream.flush();
+    checkStream(stream, "write header");
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "TrackerStore/TrackerStore.h"
+#include "Filesystem/File/File.h"
+#include <tl/optional.hpp>
+#include <memory>
+#include <stdint.h>
+
+// Keeps the history as fixed width float records in a circular file. Appending a value writes
+// only its record and one header, which saves rendering and parsing JSON. The filesystem may still
+// rewrite more: LittleFS rewrites every block from the first changed one to the end of the file,
+// and the header is at the start, so the flash wear still grows with the sample count.
+// The header is kept twice and the copies are written alternately, so a power loss during a write
+// falls back to the previous state instead of losing the history.
+class BinaryTrackerStore : public TrackerStore
+{
+public:
+    BinaryTrackerStore(std::unique_ptr<Filesystem::File> file, size_t sampleCount) noexcept;
+    json getData() override;
+    void setData(const json& data) override;
+    void append(const std::vector<float>& values, time_t timestamp) override;
+    void remove() override;
+    tl::optional<time_t> getEpoch();
+
+private:
+    struct Header
+    {
+        uint32_t capacity;
+        uint32_t head;      // Record index the next value is written to
+        uint32_t count;
+        uint32_t sequence;  // Incremented on every write, selects the newer of both header copies
+        int64_t epoch;      // Timestamp of the newest value
+    };
+
+    tl::optional<Header>& getHeader();
+    std::vector<float> readValues(const Header& header);
+    void initialize(const std::vector<float>& values, time_t epoch);
+    void writeHeader(std::iostream& stream, const Header& header);
+
+    std::unique_ptr<Filesystem::File> m_file;
+    size_t m_sampleCount;
+    tl::optional<Header> m_header;
+    bool m_isHeaderLoaded = false;
+};
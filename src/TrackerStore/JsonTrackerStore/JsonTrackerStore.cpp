@@ -0,0 +1,61 @@
+#include "JsonTrackerStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+#include <math.h>
+#include <utility>
+
+
+JsonTrackerStore::JsonTrackerStore(std::unique_ptr<JsonResource> dataResource, size_t sampleCount) noexcept :
+    m_dataResource(std::move(dataResource)),
+    m_sampleCount(sampleCount)
+{}
+
+
+json JsonTrackerStore::getData()
+{
+    return m_dataResource->deserializeOr(json());
+}
+
+
+void JsonTrackerStore::setData(const json& data)
+{
+    m_dataResource->serialize(data);
+}
+
+
+void JsonTrackerStore::append(const std::vector<float>& values, time_t)
+{
+    try
+    {
+        json data = m_dataResource->deserializeOr(json::array_t());
+
+        for (const auto& value : values)
+        {
+            if (isfinite(value))
+                data.push_back(value);
+            else
+                data.push_back(nullptr);
+        }
+
+        if(data.size() > m_sampleCount)
+            data.erase(data.begin(), data.begin() + data.size() - m_sampleCount);
+
+        if (data.size() > m_sampleCount)
+        {
+            throw std::runtime_error(SOURCE_LOCATION + "Too many values");
+        }
+
+        m_dataResource->serialize(data);
+    }
+    catch(...)
+    {
+        ExceptionTrace::trace(SOURCE_LOCATION + "Failed to append " + json(values).dump());
+        throw;
+    }
+}
+
+
+void JsonTrackerStore::remove()
+{
+    m_dataResource->remove();
+}
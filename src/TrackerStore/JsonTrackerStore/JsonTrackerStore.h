@@ -0,0 +1,20 @@
+#pragma once
+
+#include "TrackerStore/TrackerStore.h"
+#include "JsonResource/JsonResource.h"
+#include <memory>
+
+// Keeps the whole history as one JSON array, which is rewritten on every append
+class JsonTrackerStore : public TrackerStore
+{
+public:
+    JsonTrackerStore(std::unique_ptr<JsonResource> dataResource, size_t sampleCount) noexcept;
+    json getData() override;
+    void setData(const json& data) override;
+    void append(const std::vector<float>& values, time_t timestamp) override;
+    void remove() override;
+
+private:
+    std::unique_ptr<JsonResource> m_dataResource;
+    size_t m_sampleCount;
+};
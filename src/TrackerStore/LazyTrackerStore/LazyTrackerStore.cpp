@@ -0,0 +1,56 @@
+#include "LazyTrackerStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "SourceLocation/SourceLocation.h"
+
+
+LazyTrackerStore::LazyTrackerStore(Opener opener) noexcept :
+    m_opener(std::move(opener))
+{}
+
+
+json LazyTrackerStore::getData()
+{
+    return open().getData();
+}
+
+
+void LazyTrackerStore::setData(const json& data)
+{
+    open().setData(data);
+}
+
+
+void LazyTrackerStore::append(const std::vector<float>& values, time_t timestamp)
+{
+    open().append(values, timestamp);
+}
+
+
+void LazyTrackerStore::remove()
+{
+    open().remove();
+}
+
+
+bool LazyTrackerStore::isOpen() const noexcept
+{
+    return m_store != nullptr;
+}
+
+
+TrackerStore& LazyTrackerStore::open()
+{
+    if (m_store == nullptr)
+    {
+        try
+        {
+            m_store = m_opener();
+        }
+        catch (...)
+        {
+            ExceptionTrace::trace(SOURCE_LOCATION + "Failed to open tracker store");
+            throw;
+        }
+    }
+    return *m_store;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "TrackerStore/TrackerStore.h"
+#include <functional>
+#include <memory>
+
+// Opens the actual store on first access, so creating a tracker does not touch the filesystem.
+class LazyTrackerStore : public TrackerStore
+{
+public:
+    using Opener = std::function<std::unique_ptr<TrackerStore>()>;
+
+    explicit LazyTrackerStore(Opener opener) noexcept;
+
+    json getData() override;
+    void setData(const json& data) override;
+    void append(const std::vector<float>& values, time_t timestamp) override;
+    void remove() override;
+    bool isOpen() const noexcept;
+
+private:
+    TrackerStore& open();
+
+    Opener m_opener;
+    std::unique_ptr<TrackerStore> m_store;
+};
\ No newline at end of file
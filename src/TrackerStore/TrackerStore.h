@@ -0,0 +1,17 @@
+#pragma once
+
+#include <json.hpp>
+#include <time.h>
+#include <vector>
+
+// Persistent history of a Tracker, holding at most sampleCount values ordered from oldest to newest.
+// Values that are not finite stand for periods without measurements and are rendered as null.
+class TrackerStore
+{
+public:
+    virtual json getData() = 0;
+    virtual void setData(const json& data) = 0;
+    virtual void append(const std::vector<float>& values, time_t timestamp) = 0;
+    virtual void remove() = 0;
+    inline virtual ~TrackerStore() noexcept = default;
+};
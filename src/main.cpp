@@ -1,19 +1,29 @@
 #if defined(ESP32) && !defined(PIO_UNIT_TESTING)
 
 #include "Api/Api.h"
+#include "BootTimeline/BootTimeline.h"
 #include "Config/Config.h"
+#include "ConfigStore/ConfigStore.h"
 #include "Logger/Logger.h"
 #include "SourceLocation/SourceLocation.h"
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "MeasuringUnit/MeasuringUnit.h"
+#include "MeasurementPush/MeasurementPush.h"
+#include "EnergyRegister/EnergyRegister.h"
+#include "TimeSeriesStore/TimeSeriesStore.h"
 #include "JsonResource/BackedUpJsonResource/BackedUpJsonResource.h"
 #include "JsonResource/BasicJsonResource/BasicJsonResource.h"
+#include "JsonResource/CoalescingJsonResource/CoalescingJsonResource.h"
 #include "ScopeProfiler/ScopeProfiler.h"
 #include "Filesystem/Directory/LittleFsDirectory/LittleFsDirectory.h"
 #include "Filesystem/File/LittleFsFile/LittleFsFile.h"
 #include "RestApi/RestApi.h"
 #include "Rtos/Task/Task.h"
 #include "Rtos/ValueMutex/ValueMutex.h"
+#include "Rtos/SeqLock/SeqLock.h"
+#include "Rtos/SafePoint/SafePoint.h"
+#include "Rtos/PublishedValue/PublishedValue.h"
+#include "TrackerCascade/TrackerCascade.h"
 #include "WifiScan/WifiScan.h"
 #include <tuple>
 #include <LittleFS.h>
@@ -21,40 +31,56 @@
 #include <fstream>
 #include <esp_task_wdt.h>
 
+// Bounds both the flash wear and the energy lost on a power cut
+constexpr time_t energyCheckpointInterval_s = 600;
+// Minute averages appended since the last flush are lost on a power cut
+constexpr time_t powerHistoryFlushInterval_s = 900;
+constexpr time_t powerHistoryResolution_s = 60;
+// A chunk holds about 1000 minute averages, so 96 chunks of at most 4 kB hold about two months
+constexpr uint32_t powerHistoryChunkCount = 96;
+// 2024-01-01. An RTC which lost its time starts over in 2000, the history is paused until the clock is set.
+constexpr time_t minValidTimestamp = 1704067200;
+// Every measuring window is pushed, clients which need less can ask for a higher decimation
+constexpr uint32_t measurementPushDecimation = 1;
+
 
 void setup()
 {
+    static BootTimeline bootTimeline;
     esp_task_wdt_init(10, true);
     Serial.begin(115200);
     try
     {
         if (!LittleFS.begin(true, "", 30))
             throw std::runtime_error("Failed to mount Filesystem");
+        bootTimeline.mark("Filesystem");
 
-        static BackedUpJsonResource switchConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Switch.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Switch.b.json")))
-        );
-        static BackedUpJsonResource loggerConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Logger.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Logger.b.json")))
-        );
-        static BackedUpJsonResource networkConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Network.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Network.b.json")))
-        );
-        static BackedUpJsonResource measuringConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Measuring.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Measuring.b.json")))
-        );
-        static BackedUpJsonResource clockConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Clock.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Clock.b.json")))
-        );
-        static BackedUpJsonResource trackerConfigResource(
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Tracker.a.json"))),
-            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Tracker.b.json")))
+        static ConfigStore configStore(std::unique_ptr<JsonResource>(new BackedUpJsonResource(
+            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Config.a.json"))),
+            BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Config/Config.b.json")))
+        )));
+        {
+            // Configs used to be kept in one pair of files each
+            ConfigStore::LegacyResources legacyConfigResources;
+            for (const char* name : {"Switch", "Logger", "Network", "Measuring", "Clock", "Tracker"})
+            {
+                legacyConfigResources[name].reset(new BackedUpJsonResource(
+                    BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile(std::string("/Config/") + name + ".a.json"))),
+                    BasicJsonResource(std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile(std::string("/Config/") + name + ".b.json")))
+                ));
+            }
+            configStore.import(legacyConfigResources);
+        }
+        static ConfigStore::Section switchConfigResource(&configStore, "Switch");
+        static ConfigStore::Section loggerConfigResource(&configStore, "Logger");
+        // Rewritten by the WiFi task on every reconnect, mostly with unchanged values
+        static CoalescingJsonResource networkConfigResource(
+            std::unique_ptr<JsonResource>(new ConfigStore::Section(&configStore, "Network")),
+            std::chrono::milliseconds(0)
         );
+        static ConfigStore::Section measuringConfigResource(&configStore, "Measuring");
+        static ConfigStore::Section clockConfigResource(&configStore, "Clock");
+        static ConfigStore::Section trackerConfigResource(&configStore, "Tracker");
 
         static const Version firmwareVersion(
             POWERMETER_FIRMWARE_VERSION_MAJOR,
@@ -87,47 +113,200 @@ void setup()
         Logger[LogLevel::Info] << "Booting..." << std::endl;
         Logger[LogLevel::Info] << "Firmware version v" << firmwareVersion << std::endl;
         Logger[LogLevel::Info] << "API version v" << apiVersion << std::endl;
-        Config::configureNetwork(&networkConfigResource);
+        bootTimeline.mark("Logger");
+
+        // Measuring starts before anything waits for the network or reads the tracker history
         static Switch* switchUnit = Config::configureSwitch(&switchConfigResource);
         static Clock* clock = Config::configureClock(&clockConfigResource);
         static MeasuringUnit* measuringUnit = Config::configureMeasuring(&measuringConfigResource);
-        static Rtos::ValueMutex<MeasurementList> measurementsValueMutex;
+        // The measuring unit is only replaced by the measuring task, between two windows
+        static Rtos::SafePoint measuringSafePoint;
+        // Written by the measuring task without ever waiting for a reader
+        static Rtos::SeqLock<MeasurementFrame> measurements;
+        static CycleRing cycleRing;
+        // Integrated by the measuring task and checkpointed by the tracker task, without a lock between them
+        static EnergyRegister energyRegister(
+            clock,
+            std::unique_ptr<JsonResource>(new BackedUpJsonResource(
+                BasicJsonResource(
+                    std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Energy/Register.a.json")),
+                    true,
+                    BasicJsonResource::Encoding::Cbor
+                ),
+                BasicJsonResource(
+                    std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile("/Energy/Register.b.json")),
+                    true,
+                    BasicJsonResource::Encoding::Cbor
+                )
+            )),
+            energyCheckpointInterval_s
+        );
+        {
+            // The power history used to be a circular file of half the filesystem
+            Filesystem::LittleFsFile legacyPowerHistoryFile("/History/power.tss");
+            try
+            {
+                if (legacyPowerHistoryFile.exists())
+                {
+                    legacyPowerHistoryFile.remove();
+                    Logger[LogLevel::Info] << "Removed the power history of the previous format." << std::endl;
+                }
+            }
+            catch (...)
+            {
+                Logger[LogLevel::Warning] << "Failed to remove the power history of the previous format:\n" << ExceptionTrace::what() << std::endl;
+            }
+        }
+        static Rtos::ValueMutex<TimeSeriesStore> powerHistoryValueMutex(TimeSeriesStore(
+            std::unique_ptr<Filesystem::Directory>(new Filesystem::LittleFsDirectory("/History/power")),
+            [](const std::string& path){
+                return std::unique_ptr<Filesystem::File>(new Filesystem::LittleFsFile(path));
+            },
+            powerHistoryChunkCount
+        ));
+        bootTimeline.mark("Measuring");
+
+        static Rtos::Task measuringTask("Measuring", 10, 3000, [](Rtos::Task* task){
+                tl::optional<BootTimeline::TimePoint> firstMeasurementStart = std::chrono::steady_clock::now();
+                while (true)
+                {
+                    measuringSafePoint.pass();
+                    if (measuringUnit == nullptr)
+                    {
+                        measurements.store(MeasurementFrame());
+                        delay(1000);
+                        continue;
+                    }
+                    MeasurementFrame frame = measuringUnit->measure(cycleRing);
+                    measurements.store(frame);
+                    energyRegister.add(frame);
+                    if (firstMeasurementStart.has_value())
+                    {
+                        bootTimeline.mark("First measurement", firstMeasurementStart.value());
+                        firstMeasurementStart = tl::nullopt;
+                    }
+                    // Only yields to other tasks, the sampler keeps converting in the background
+                    delay(1);
+                }
+            },
+            Rtos::CpuCore::Core1
+        );
+
+        Config::configureNetwork(&networkConfigResource);
+        bootTimeline.mark("Network");
+
+        // Filled by the tracker task, so loading the trackers does not hold up the HTTP server.
+        // Until then the data is null and the tracker endpoints answer with 503.
         static Rtos::ValueMutex<TrackerMap> trackersValueMutex;
-        *trackersValueMutex.get() = Config::configureTrackers(&trackerConfigResource, clock);
+        static Rtos::PublishedValue<json> trackersData;
 
-        Api::createSystemEndpoints(&restApi, firmwareVersion, apiVersion);
+        Api::createSystemEndpoints(&restApi, firmwareVersion, apiVersion, &bootTimeline);
         Api::createLoggerEndpoints(&restApi, &loggerConfigResource, &server);
         Api::createSwitchEndpoints(&restApi, &switchConfigResource, &switchUnit);
         Api::createClockEndpoints(&restApi, &clockConfigResource, &clock);
-        Api::createTrackerEndpoints(&restApi, &trackerConfigResource, &trackersValueMutex, clock);
+        Api::createTrackerEndpoints(&restApi, &trackerConfigResource, &trackersValueMutex, &trackersData, clock);
         Api::createNetworkEndpoints(&restApi, &networkConfigResource);
-        Api::createMeasuringEndpoints(&restApi, &measuringConfigResource, &measuringUnit, &measurementsValueMutex);
+        Api::createMeasuringEndpoints(&restApi, &measuringConfigResource, &measuringUnit, &measuringSafePoint, &measurements, &cycleRing, &energyRegister);
+        Api::createHistoryEndpoints(&restApi, &powerHistoryValueMutex);
+        static MeasurementPush measurementPush(
+            &server,
+            "/api/v" + std::string(apiVersion) + "/measurements/live",
+            &measurements,
+            measurementPushDecimation
+        );
         server.begin();
+        bootTimeline.mark("HTTP server");
 
         Logger[LogLevel::Info] << "Boot sequence finished. Running..." << std::endl;
 
-        static Rtos::Task measuringTask("Measuring", 10, 3000, [](Rtos::Task* task){
-                while (true)
-                {
-                    *measurementsValueMutex.get() = measuringUnit->measure();
-                    delay(1000);
-                }
-            },
-            Rtos::CpuCore::Core1
-        );
-
         static Rtos::Task trackerTask("Tracker", 2, 8000, [](Rtos::Task* task){
+            {
+                BootTimeline::TimePoint trackersStart = std::chrono::steady_clock::now();
+                Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex.get();
+                *trackers = Config::configureTrackers(&trackerConfigResource, clock);
+                trackersData.publish(getTrackersData(*trackers));
+                bootTimeline.mark("Trackers", trackersStart);
+            }
+
+            time_t historyPeriod = 0;
+            float historySum = 0;
+            size_t historyCount = 0;
+            bool isHistoryRecording = true;
+            time_t lastHistoryFlush = clock->now();
             while (true)
             {
+                // A failing stage is logged and retried with the next round, without stopping the others
+                MeasurementFrame latestMeasurements = measurements.load();
+                if (latestMeasurements.isValid())
                 {
-                    MeasurementList measurements = *measurementsValueMutex.get();
-                    if (measurements.size() > 0)
+                    float power = latestMeasurements.getActivePower_W();
+                    try
                     {
                         Rtos::ValueMutex<TrackerMap>::Lock trackers = trackersValueMutex.get();
-                        for (auto& tracker : *trackers)
-                            tracker.second.track(measurements.front().value);
+                        if (TrackerCascade::track(*trackers, power))
+                            trackersData.publish(getTrackersData(*trackers));
                     }
+                    catch (...)
+                    {
+                        Logger[LogLevel::Error] << "Failed to track the power:\n" << ExceptionTrace::what() << std::endl;
+                    }
+
+                    time_t now = clock->now();
+                    if ((now >= minValidTimestamp) != isHistoryRecording)
+                    {
+                        isHistoryRecording = now >= minValidTimestamp;
+                        historySum = 0;
+                        historyCount = 0;
+                        if (isHistoryRecording)
+                            Logger[LogLevel::Info] << "Clock is set, recording the power history." << std::endl;
+                        else
+                            Logger[LogLevel::Warning] << "Clock is not set, pausing the power history." << std::endl;
+                    }
+                    try
+                    {
+                        if (isHistoryRecording)
+                        {
+                            time_t period = now / powerHistoryResolution_s;
+                            if (period != historyPeriod && historyCount > 0)
+                            {
+                                time_t timestamp = historyPeriod * powerHistoryResolution_s;
+                                float average = historySum / historyCount;
+                                historySum = 0;
+                                historyCount = 0;
+                                if (!powerHistoryValueMutex.get()->append(timestamp, average))
+                                {
+                                    Logger[LogLevel::Warning]
+                                        << "Power history rejected the average at " << timestamp
+                                        << ", it is not newer than the last one." << std::endl;
+                                }
+                            }
+                            historyPeriod = period;
+                            historySum += power;
+                            historyCount++;
+                        }
+
+                        if (now - lastHistoryFlush >= powerHistoryFlushInterval_s || now < lastHistoryFlush)
+                        {
+                            lastHistoryFlush = now;
+                            powerHistoryValueMutex.get()->flush();
+                        }
+                    }
+                    catch (...)
+                    {
+                        // The open chunk stays in RAM and is written again with the next flush
+                        Logger[LogLevel::Error] << "Failed to record the power history:\n" << ExceptionTrace::what() << std::endl;
+                    }
+                }
+
+                try
+                {
+                    energyRegister.checkpoint();
+                }
+                catch (...)
+                {
+                    Logger[LogLevel::Error] << "Failed to checkpoint the energy register:\n" << ExceptionTrace::what() << std::endl;
                 }
+                CoalescingJsonResource::flushAll();
                 delay(1000);
             }
         });
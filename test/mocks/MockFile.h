@@ -33,10 +33,19 @@ struct MockFile : public Filesystem::File
     Stream open(std::ios::openmode mode = std::ios::in) override
     {
         if (mode & std::ios::out)
-        {
             lastWriteTimestamp = std::time(nullptr);
+
+        // Like std::fstream, only in | out keeps the content unless truncating is requested
+        stream.clear();
+        if ((mode & std::ios::out) && (!(mode & std::ios::in) || (mode & std::ios::trunc)))
+        {
             stream.str("");
         }
+        else
+        {
+            stream.seekg(0);
+            stream.seekp(0);
+        }
 
         return Stream(&stream, [](std::iostream*){});
     }
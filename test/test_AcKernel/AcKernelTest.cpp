@@ -0,0 +1,227 @@
+#include "AdcSampler/SyntheticAdcSampler/SyntheticAdcSampler.h"
+#include "AcKernel/FloatingPointAcKernel/FloatingPointAcKernel.h"
+#include "AcKernel/FixedPointAcKernel/FixedPointAcKernel.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <vector>
+
+
+constexpr uint32_t sampleRate_Hz = 5000;
+constexpr AcCalibration calibration = {
+    .voltage = 536.9f,
+    .current = 15.7f,
+    .phase = -5.6f,
+};
+
+const SyntheticAdcSampler::Signal voltageSignal = {
+    .offset_counts = 1900.0f,
+    .harmonics = {
+        {1, 1100.0f, 0.0f},
+        {3, 40.0f, 0.3f},
+        {5, 25.0f, 1.1f},
+    },
+    .noise_counts = 3.0f,
+};
+
+// Distorted current as drawn by a rectifier with a capacitive input stage
+const SyntheticAdcSampler::Signal currentSignal = {
+    .offset_counts = 2100.0f,
+    .harmonics = {
+        {1, 600.0f, -0.4f},
+        {3, 350.0f, 0.2f},
+        {5, 180.0f, 0.9f},
+        {7, 90.0f, 1.7f},
+    },
+    .noise_counts = 3.0f,
+};
+
+
+struct AcKernelTest : public testing::Test
+{
+    void SetUp() override
+    {
+        SyntheticAdcSampler sampler(voltageSignal, currentSignal, sampleRate_Hz);
+        blocks.resize(500);
+        for (auto& block : blocks)
+            sampler.read(block);
+    }
+
+    std::vector<AdcSampleBlock> blocks;
+};
+
+
+TEST_F(AcKernelTest, fixedPointMatchesFloatingPoint)
+{
+    FloatingPointAcKernel reference(calibration);
+    FixedPointAcKernel uut(calibration);
+
+    for (size_t window = 0; window < 25; window++)
+    {
+        for (size_t i = 0; i < blocks.size() / 25; i++)
+        {
+            const AdcSampleBlock& block = blocks.at(window * blocks.size() / 25 + i);
+            reference.process(block);
+            uut.process(block);
+        }
+        AcPower expected = reference.getResult();
+        AcPower actual = uut.getResult();
+        EXPECT_NEAR(expected.getVoltage_V(), actual.getVoltage_V(), expected.getVoltage_V() * 0.001f);
+        EXPECT_NEAR(expected.getCurrent_A(), actual.getCurrent_A(), expected.getCurrent_A() * 0.001f);
+        EXPECT_NEAR(expected.getActivePower_W(), actual.getActivePower_W(), expected.getApparentPower_VA() * 0.001f);
+    }
+}
+
+
+TEST_F(AcKernelTest, emptyWindowIsZero)
+{
+    FixedPointAcKernel uut(calibration);
+    AcPower result = uut.getResult();
+    EXPECT_EQ(0.0f, result.getVoltage_V());
+    EXPECT_EQ(0.0f, result.getCurrent_A());
+    EXPECT_EQ(0.0f, result.getActivePower_W());
+}
+
+
+TEST_F(AcKernelTest, publishesOneResultPerCycle)
+{
+    FixedPointAcKernel uut(calibration);
+    FloatingPointAcKernel reference(calibration);
+    CycleRing cycleRing;
+    CycleRing referenceCycleRing;
+    uut.setCycleRing(&cycleRing);
+    reference.setCycleRing(&referenceCycleRing);
+    CycleRing::Cursor cursor = cycleRing.getCursor();
+    CycleRing::Cursor referenceCursor = referenceCycleRing.getCursor();
+
+    // 160 blocks of 32 samples at 5 kHz are 1.024 s, so 51 cycles at 50 Hz
+    size_t cycleCount = 0;
+    for (size_t i = 0; i < 160; i++)
+    {
+        uut.process(blocks.at(i));
+        reference.process(blocks.at(i));
+
+        CycleMeasurement cycle;
+        CycleMeasurement referenceCycle;
+        while (cycleRing.pop(cursor, cycle))
+        {
+            ASSERT_TRUE(referenceCycleRing.pop(referenceCursor, referenceCycle));
+            EXPECT_EQ(referenceCycle.timestamp_us, cycle.timestamp_us);
+            EXPECT_NEAR(20000, cycle.duration_us, 400);
+            EXPECT_NEAR(referenceCycle.activePower_W, cycle.activePower_W, fabsf(referenceCycle.activePower_W) * 0.002f);
+            cycleCount++;
+        }
+    }
+    EXPECT_NEAR(51, cycleCount, 1);
+}
+
+
+TEST_F(AcKernelTest, detectsLoadStepWithinOneCycle)
+{
+    SyntheticAdcSampler sampler(voltageSignal, currentSignal, sampleRate_Hz);
+    FixedPointAcKernel uut(calibration);
+    CycleRing cycleRing;
+    uut.setCycleRing(&cycleRing, true);
+    CycleRing::Cursor cursor = cycleRing.getCursor();
+    AdcSampleBlock block;
+    CycleMeasurement cycle;
+
+    for (size_t i = 0; i < 100; i++)
+    {
+        sampler.read(block);
+        uut.process(block);
+    }
+    while (cycleRing.pop(cursor, cycle));
+    float loadedCurrent_A = cycle.current_A;
+
+    sampler.setCurrentSignal({2100.0f, {}, 0.0f});
+    uint64_t stepSampleIndex = 100 * AdcSampleBlock::capacity;
+    uint64_t stepTimestamp_us = stepSampleIndex * 1000000ull / sampleRate_Hz;
+    uint64_t sampleIndex = stepSampleIndex;
+    bool isDetected = false;
+    for (size_t i = 0; i < 100 && !isDetected; i++)
+    {
+        sampler.read(block);
+        uut.process(block);
+        sampleIndex += block.size;
+        while (!isDetected && cycleRing.pop(cursor, cycle))
+            isDetected = cycle.current_A < loadedCurrent_A * 0.1f;
+    }
+    ASSERT_TRUE(isDetected);
+    // Half cycles at 50 Hz are 10 ms long, so the first unloaded one ends at most 20 ms after the step
+    EXPECT_LE(cycle.timestamp_us - stepTimestamp_us, 20000);
+    // and it is published together with the block it ends in
+    EXPECT_LE((sampleIndex - stepSampleIndex) * 1000000ull / sampleRate_Hz, 20000);
+}
+
+
+TEST_F(AcKernelTest, dropsCycleWithoutZeroCrossing)
+{
+    SyntheticAdcSampler noVoltageSampler({1900.0f, {}, 3.0f}, currentSignal, sampleRate_Hz);
+    FixedPointAcKernel uut(calibration);
+    FloatingPointAcKernel reference(calibration);
+    CycleRing cycleRing;
+    uut.setCycleRing(&cycleRing);
+    reference.setCycleRing(&cycleRing);
+    CycleRing::Cursor cursor = cycleRing.getCursor();
+    AdcSampleBlock block;
+
+    for (AcKernel* kernel : std::vector<AcKernel*>{&uut, &reference})
+    {
+        for (size_t i = 0; i < 50; i++)
+            kernel->process(blocks.at(i));
+        for (size_t i = 0; i < 500; i++)
+        {
+            noVoltageSampler.read(block);
+            kernel->process(block);
+        }
+        for (size_t i = 50; i < 100; i++)
+            kernel->process(blocks.at(i));
+        EXPECT_GT(kernel->getResult().getCurrent_A(), 0.0f);
+    }
+
+    // The cycle, which was open when the voltage vanished, is not published as one long cycle
+    CycleMeasurement cycle;
+    size_t cycleCount = 0;
+    while (cycleRing.pop(cursor, cycle))
+    {
+        EXPECT_NEAR(20000, cycle.duration_us, 400);
+        cycleCount++;
+    }
+    EXPECT_GT(cycleCount, 0);
+}
+
+
+double benchmark(AcKernel& kernel, const std::vector<AdcSampleBlock>& blocks)
+{
+    constexpr size_t repetitions = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; i++)
+    {
+        for (const auto& block : blocks)
+            kernel.process(block);
+        kernel.getResult();
+    }
+    std::chrono::duration<double> duration_s = std::chrono::steady_clock::now() - start;
+    return repetitions * blocks.size() * AdcSampleBlock::capacity / duration_s.count();
+}
+
+
+TEST_F(AcKernelTest, benchmark)
+{
+    FloatingPointAcKernel floatingPointKernel(calibration);
+    FixedPointAcKernel fixedPointKernel(calibration);
+
+    double floatingPointSamplesPerSecond = benchmark(floatingPointKernel, blocks);
+    double fixedPointSamplesPerSecond = benchmark(fixedPointKernel, blocks);
+    std::cout << "Floating point kernel: " << floatingPointSamplesPerSecond << " samples/s" << std::endl;
+    std::cout << "Fixed point kernel:    " << fixedPointSamplesPerSecond << " samples/s" << std::endl;
+    EXPECT_GT(fixedPointSamplesPerSecond, sampleRate_Hz);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
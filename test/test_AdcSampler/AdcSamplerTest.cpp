@@ -0,0 +1,114 @@
+#include "AdcSampler/SyntheticAdcSampler/SyntheticAdcSampler.h"
+#include "AcKernel/FloatingPointAcKernel/FloatingPointAcKernel.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <math.h>
+
+
+constexpr uint32_t sampleRate_Hz = 5000;
+constexpr AcCalibration calibration = {
+    .voltage = 536.9f,
+    .current = 15.7f,
+    .phase = 1.0f,
+};
+
+const SyntheticAdcSampler::Signal voltageSignal = {
+    .offset_counts = 2048.0f,
+    .harmonics = {{1, 1000.0f, 0.0f}},
+    .noise_counts = 0.0f,
+};
+
+const SyntheticAdcSampler::Signal currentSignal = {
+    .offset_counts = 2048.0f,
+    .harmonics = {{1, 500.0f, 0.0f}},
+    .noise_counts = 0.0f,
+};
+
+
+float countsToRms(float amplitude_counts, float calibration)
+{
+    return amplitude_counts / sqrtf(2.0f) * calibration * adcReferenceVoltage_V / adcResolution_counts;
+}
+
+
+TEST(AdcSamplerTest, blocksAreGapless)
+{
+    SyntheticAdcSampler uut(voltageSignal, currentSignal, sampleRate_Hz);
+    SyntheticAdcSampler reference(voltageSignal, currentSignal, sampleRate_Hz);
+    AdcSampleBlock block;
+    AdcSampleBlock referenceBlock;
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        uut.read(block);
+        EXPECT_EQ(i, block.sequenceNumber);
+        EXPECT_EQ(AdcSampleBlock::capacity, block.size);
+        EXPECT_EQ(sampleRate_Hz, block.sampleRate_Hz);
+    }
+
+    // The 11th block has to continue exactly where the 10th ended
+    for (uint32_t i = 0; i < 11; i++)
+        reference.read(referenceBlock);
+    uut.read(block);
+    for (size_t i = 0; i < block.size; i++)
+        EXPECT_EQ(referenceBlock.voltage[i], block.voltage[i]);
+}
+
+
+TEST(AdcSamplerTest, floatingPointKernelMeasuresSine)
+{
+    SyntheticAdcSampler sampler(voltageSignal, currentSignal, sampleRate_Hz);
+    FloatingPointAcKernel uut(calibration);
+    AdcSampleBlock block;
+
+    // Let the offset filters settle
+    for (size_t i = 0; i < 200; i++)
+    {
+        sampler.read(block);
+        uut.process(block);
+    }
+    uut.getResult();
+
+    for (size_t i = 0; i < sampleRate_Hz / AdcSampleBlock::capacity; i++)
+    {
+        sampler.read(block);
+        uut.process(block);
+    }
+    AcPower result = uut.getResult();
+
+    float expectedVoltage_V = countsToRms(1000.0f, calibration.voltage);
+    float expectedCurrent_A = countsToRms(500.0f, calibration.current);
+    EXPECT_NEAR(expectedVoltage_V, result.getVoltage_V(), expectedVoltage_V * 0.005f);
+    EXPECT_NEAR(expectedCurrent_A, result.getCurrent_A(), expectedCurrent_A * 0.005f);
+    EXPECT_NEAR(expectedVoltage_V * expectedCurrent_A, result.getActivePower_W(), expectedVoltage_V * expectedCurrent_A * 0.01f);
+}
+
+
+TEST(AdcSamplerTest, benchmark)
+{
+    SyntheticAdcSampler sampler(voltageSignal, currentSignal, sampleRate_Hz);
+    FloatingPointAcKernel kernel(calibration);
+    AdcSampleBlock block;
+    constexpr size_t blockCount = 2000;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < blockCount; i++)
+    {
+        sampler.read(block);
+        kernel.process(block);
+    }
+    std::chrono::duration<double> duration_s = std::chrono::steady_clock::now() - start;
+    kernel.getResult();
+
+    double samplesPerSecond = blockCount * AdcSampleBlock::capacity / duration_s.count();
+    std::cout << "Synthetic sampler + floating point kernel: " << samplesPerSecond << " samples/s" << std::endl;
+    EXPECT_GT(samplesPerSecond, sampleRate_Hz);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -49,6 +49,25 @@ TEST_F(AverageAccumulatorTest, shouldResetToZero)
 }
 
 
+TEST_F(AverageAccumulatorTest, shouldOnlyWriteOnCheckpoint)
+{
+    MockJsonResource* storageResource = new MockJsonResource();
+    AverageAccumulator accumulator = AverageAccumulator(std::unique_ptr<JsonResource>(storageResource));
+    accumulator.add(2.0f, 3);
+    accumulator.add(4.0f);
+    EXPECT_EQ(2, accumulator.getUnsavedChangeCount());
+    EXPECT_TRUE(storageResource->deserialize().is_null());
+
+    accumulator.checkpoint();
+    EXPECT_EQ(0, accumulator.getUnsavedChangeCount());
+    EXPECT_EQ(4, storageResource->deserialize().at("count"));
+
+    AverageAccumulator restored(std::make_unique<MockJsonResource>(*storageResource));
+    EXPECT_EQ(4, restored.getCount());
+    EXPECT_EQ(2.5f, restored.getAverage());
+}
+
+
 int main()
 {
     testing::InitGoogleTest();
@@ -4,6 +4,15 @@
 #include <gtest/gtest.h>
 
 const json testJson = {"foo", 43};
+constexpr size_t headerSize = 20;
+
+
+// Data of a copy written with header
+json parseCopy(const std::string& content)
+{
+    return json::parse(content.substr(headerSize));
+}
+
 
 struct BackedUpJsonResourceTest : public testing::Test
 {
@@ -13,6 +22,18 @@ struct BackedUpJsonResourceTest : public testing::Test
         BasicJsonResource(std::unique_ptr<Filesystem::File>(mockFileA)),
         BasicJsonResource(std::unique_ptr<Filesystem::File>(mockFileB))
     );
+
+    BackedUpJsonResource reopen()
+    {
+        MockFile* reopenedFileA = new MockFile("MockFileA path", "MockFileA name");
+        MockFile* reopenedFileB = new MockFile("MockFileB path", "MockFileB name");
+        reopenedFileA->stream.str(mockFileA->stream.str());
+        reopenedFileB->stream.str(mockFileB->stream.str());
+        return BackedUpJsonResource(
+            BasicJsonResource(std::unique_ptr<Filesystem::File>(reopenedFileA)),
+            BasicJsonResource(std::unique_ptr<Filesystem::File>(reopenedFileB))
+        );
+    }
 };
 
 
@@ -22,7 +43,7 @@ TEST_F(BackedUpJsonResourceTest, serialize)
     mockFileB->lastWriteTimestamp = 2;
     // Should serialize to A now
     uut.serialize(testJson);
-    EXPECT_EQ(testJson, json::parse(mockFileA->stream));
+    EXPECT_EQ(testJson, parseCopy(mockFileA->stream.str()));
     EXPECT_TRUE(mockFileB->stream.str().empty());
 }
 
@@ -47,8 +68,64 @@ TEST_F(BackedUpJsonResourceTest, corruptedFile)
     EXPECT_EQ(testJson, uut.deserialize());
     EXPECT_ANY_THROW(json::parse(mockFileB->stream));
     uut.serialize(testJson);
-    std::cout << mockFileB->stream.str() << std::endl;
-    EXPECT_EQ(testJson, json::parse(mockFileB->stream));
+    EXPECT_EQ(testJson, parseCopy(mockFileB->stream.str()));
+}
+
+
+TEST_F(BackedUpJsonResourceTest, newestCopyIsFoundBySequence)
+{
+    try
+    {
+        for (int i = 0; i < 5; i++)
+            uut.serialize(i);
+        // Timestamps are not looked at anymore, once the copies have a header
+        mockFileA->lastWriteTimestamp = 2;
+        mockFileB->lastWriteTimestamp = 1;
+        EXPECT_EQ(reopen().deserialize(), 4);
+
+        // A torn write of the next copy falls back to the previous one
+        uut.serialize(5);
+        MockFile* newestFile = parseCopy(mockFileA->stream.str()) == 5 ? mockFileA : mockFileB;
+        std::string content = newestFile->stream.str();
+        content[content.size() - 1] = '6';
+        newestFile->stream.str(content);
+        EXPECT_EQ(reopen().deserialize(), 4);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(BackedUpJsonResourceSingleFileTest, keepsBothCopiesInOneFile)
+{
+    try
+    {
+        constexpr size_t slotSize_B = 128;
+        MockFile* mockFile = new MockFile("/Trackers/day/state.json", "state.json");
+        BackedUpJsonResource uut(BasicJsonResource(std::unique_ptr<Filesystem::File>(mockFile)), slotSize_B);
+        EXPECT_ANY_THROW(uut.deserialize());
+        ExceptionTrace::clear();
+
+        uut.serialize({{"timestamp", 1}});
+        uut.serialize({{"timestamp", 2}});
+        EXPECT_GT(mockFile->stream.str().size(), slotSize_B);
+        EXPECT_LE(mockFile->stream.str().size(), 2 * slotSize_B);
+
+        // Too large data leaves the newest copy untouched
+        EXPECT_ANY_THROW(uut.serialize(std::string(slotSize_B, 'x')));
+        ExceptionTrace::clear();
+
+        MockFile* reopenedFile = new MockFile("/Trackers/day/state.json", "state.json");
+        reopenedFile->stream.str(mockFile->stream.str());
+        BackedUpJsonResource reopened(BasicJsonResource(std::unique_ptr<Filesystem::File>(reopenedFile)), slotSize_B);
+        EXPECT_EQ(reopened.deserialize(), json({{"timestamp", 2}}));
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
 }
 
 
@@ -56,4 +133,4 @@ int main()
 {
     testing::InitGoogleTest();
     return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
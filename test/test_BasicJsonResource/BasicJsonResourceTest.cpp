@@ -0,0 +1,98 @@
+#include "JsonResource/BasicJsonResource/BasicJsonResource.h"
+#include "Filesystem/File/RamFile/RamFile.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+
+
+const json testJson = {
+    {"version", "0.2.0"},
+    {"average", 231.25},
+    {"count", 4711},
+    {"timestamp", 1700000000},
+    {"title", "Last 24 hours"},
+    {"data", {1.5, nullptr, -3, 1e30, "text"}},
+};
+
+
+struct BasicJsonResourceTest : public testing::Test
+{
+    std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+
+    BasicJsonResource createResource(BasicJsonResource::Encoding encoding)
+    {
+        return BasicJsonResource(
+            std::unique_ptr<Filesystem::File>(new Filesystem::RamFile("/Trackers/day/accumulator.a.json", storage)),
+            false,
+            encoding
+        );
+    }
+};
+
+
+TEST_F(BasicJsonResourceTest, readsAnyEncoding)
+{
+    try
+    {
+        for (auto writeEncoding : {BasicJsonResource::Encoding::Text, BasicJsonResource::Encoding::Cbor, BasicJsonResource::Encoding::MessagePack})
+        {
+            createResource(writeEncoding).serialize(testJson);
+            for (auto readEncoding : {BasicJsonResource::Encoding::Text, BasicJsonResource::Encoding::Cbor, BasicJsonResource::Encoding::MessagePack})
+                EXPECT_EQ(createResource(readEncoding).deserialize(), testJson);
+        }
+
+        // Scalars, whose binary encoding might look like text
+        createResource(BasicJsonResource::Encoding::MessagePack).serialize(49);
+        EXPECT_EQ(createResource(BasicJsonResource::Encoding::Text).deserialize(), 49);
+        createResource(BasicJsonResource::Encoding::Cbor).serialize(nullptr);
+        EXPECT_EQ(createResource(BasicJsonResource::Encoding::Text).deserialize(), nullptr);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(BasicJsonResourceTest, corruptedBinaryThrows)
+{
+    BasicJsonResource resource = createResource(BasicJsonResource::Encoding::Cbor);
+    resource.serialize(testJson);
+    std::string content = storage->readFile("/Trackers/day/accumulator.a.json")->content;
+    storage->writeFile("/Trackers/day/accumulator.a.json", content.substr(0, content.size() / 2));
+    EXPECT_ANY_THROW(resource.deserialize());
+    ExceptionTrace::clear();
+}
+
+
+TEST_F(BasicJsonResourceTest, benchmark)
+{
+    json documentJson = testJson;
+    documentJson["data"] = json::array_t();
+    for (size_t i = 0; i < 1000; i++)
+        documentJson["data"].push_back(i % 10 == 0 ? json() : json(i * 1.37f));
+
+    for (auto encoding : {BasicJsonResource::Encoding::Text, BasicJsonResource::Encoding::Cbor, BasicJsonResource::Encoding::MessagePack})
+    {
+        BasicJsonResource resource = createResource(encoding);
+        size_t writtenBefore_B = storage->getWrittenSize_B();
+        resource.serialize(documentJson);
+        size_t written_B = storage->getWrittenSize_B() - writtenBefore_B;
+
+        constexpr size_t iterationCount = 100;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterationCount; i++)
+            ASSERT_EQ(resource.deserialize().size(), documentJson.size());
+        double parse_us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / iterationCount;
+
+        std::cout << "Encoding " << static_cast<int>(encoding) << ": " << written_B << " B written, " << parse_us << " us to parse" << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
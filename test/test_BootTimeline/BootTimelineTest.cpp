@@ -0,0 +1,42 @@
+#include "BootTimeline/BootTimeline.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+
+TEST(BootTimelineTest, recordsPhases)
+{
+    try
+    {
+        BootTimeline uut;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uut.mark("Config");
+        BootTimeline::TimePoint trackersStart = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uut.mark("Network");
+        uut.mark("Trackers", trackersStart);
+
+        json timeline = uut.toJson();
+        ASSERT_EQ(timeline.size(), 3);
+        EXPECT_EQ(timeline[0].at("name"), "Config");
+        EXPECT_GE(timeline[0].at("duration_ms"), 20);
+        EXPECT_GE(timeline[1].at("duration_ms"), 20);
+        EXPECT_GE(timeline[1].at("end_ms"), 40);
+        // A phase of another task does not move the start of the next phase
+        EXPECT_GE(timeline[2].at("duration_ms"), 20);
+        uut.mark("Api");
+        EXPECT_LT(uut.toJson()[3].at("duration_ms").get<uint32_t>(), 20);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
@@ -0,0 +1,114 @@
+#include "JsonResource/CoalescingJsonResource/CoalescingJsonResource.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+#include <thread>
+
+
+struct CountingJsonResource : public JsonResource
+{
+    json deserialize() override
+    {
+        if (data.is_null())
+            throw std::runtime_error("No data");
+        return data;
+    }
+
+    void serialize(const json& newData) override
+    {
+        data = newData;
+        writeCount++;
+        if (externalWriteCount != nullptr)
+            (*externalWriteCount)++;
+    }
+
+    void remove() override
+    {
+        data = nullptr;
+    }
+
+    json data;
+    size_t writeCount = 0;
+    // Outlives the resource
+    size_t* externalWriteCount = nullptr;
+};
+
+
+TEST(CoalescingJsonResourceTest, dropsUnchangedWrites)
+{
+    try
+    {
+        CountingJsonResource* resource = new CountingJsonResource();
+        CoalescingJsonResource uut(std::unique_ptr<JsonResource>(resource), std::chrono::milliseconds(0));
+        uut.serialize({{"ssid", "home"}});
+        uut.serialize({{"ssid", "home"}});
+        uut.serialize({{"ssid", "home"}});
+        EXPECT_EQ(resource->writeCount, 1);
+        uut.serialize({{"ssid", "office"}});
+        EXPECT_EQ(resource->writeCount, 2);
+        EXPECT_EQ(uut.deserialize(), json({{"ssid", "office"}}));
+        EXPECT_EQ(uut.getStatistics().unchangedCount, 2);
+        EXPECT_EQ(uut.getStatistics().writeCount, 2);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(CoalescingJsonResourceTest, mergesWritesWithinWindow)
+{
+    try
+    {
+        CountingJsonResource* resource = new CountingJsonResource();
+        resource->data = false;
+        CoalescingJsonResource uut(std::unique_ptr<JsonResource>(resource), std::chrono::milliseconds(50));
+        for (bool state : {true, false, true, true})
+            uut.serialize(state);
+        EXPECT_EQ(uut.deserialize(), true);
+
+        CoalescingJsonResource::flushAll();
+        EXPECT_EQ(resource->writeCount, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        CoalescingJsonResource::flushAll();
+        EXPECT_EQ(resource->writeCount, 1);
+        EXPECT_EQ(resource->data, true);
+
+        CoalescingJsonResource::Statistics statistics = uut.getStatistics();
+        EXPECT_EQ(statistics.writeCount, 1);
+        EXPECT_EQ(statistics.coalescedCount, 2);
+        EXPECT_EQ(statistics.unchangedCount, 1);
+        EXPECT_GE(CoalescingJsonResource::getTotalStatistics().coalescedCount, 2);
+
+        // Returning to the stored value still needs a write, when another value is pending
+        uut.serialize(false);
+        uut.flush(true);
+        EXPECT_EQ(resource->writeCount, 2);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(CoalescingJsonResourceTest, flushesPendingOnDestruction)
+{
+    size_t writeCount = 0;
+    {
+        CountingJsonResource* resource = new CountingJsonResource();
+        resource->externalWriteCount = &writeCount;
+        CoalescingJsonResource uut(std::unique_ptr<JsonResource>(resource), std::chrono::hours(1));
+        uut.serialize(42);
+        EXPECT_EQ(writeCount, 0);
+    }
+    EXPECT_EQ(writeCount, 1);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include "Config/Config.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+
+
+// Measuring config as stored by the firmware before the config schemas existed
+const json preSeriesMeasuringConfig = {
+    {"version", "0.0.0"},
+    {"selected", "Ac"},
+    {"options", {
+        {"Simulation", {
+            {"measuringRunTime_ms", 0},
+            {"voltage", {{"min", 220}, {"max", 240}}},
+            {"current", {{"min", 0.01}, {"max", 16}}},
+            {"powerFactor", {{"min", 0.5}, {"max", 1}}},
+        }},
+        {"Ac", {
+            {"pins", {{"voltage", 33}, {"current", 32}}},
+            {"calibration", {{"voltage", 536.9}, {"current", 15.7}, {"phase", -5.6}}},
+        }},
+    }},
+};
+
+
+TEST(ConfigTest, loadsPreSeriesMeasuringConfig)
+{
+    try
+    {
+        MockJsonResource configResource;
+        configResource.serialize(preSeriesMeasuringConfig);
+
+        json configJson = Config::loadConfig(&configResource, Config::getMeasuringDefault(), Config::getMeasuringSchema());
+        // Checked first thing by configureMeasuring()
+        Config::getMeasuringSchema().validate(configJson);
+        EXPECT_EQ(configJson.at("/options/Simulation/measuringRunTime_ms"_json_pointer), 20);
+        EXPECT_EQ(configJson.at("/options/Ac"_json_pointer), preSeriesMeasuringConfig.at("/options/Ac"_json_pointer));
+        EXPECT_EQ(configResource.deserialize(), configJson);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(ConfigTest, clampsTrackerSampleCount)
+{
+    try
+    {
+        json storedConfigJson = Config::getTrackersDefault();
+        storedConfigJson["version"] = "0.0.0";
+        storedConfigJson["trackers"]["86400_2880"] = {{"title", "Last 24 Hours"}, {"duration_s", 86400}, {"sampleCount", 2880}};
+        MockJsonResource configResource;
+        configResource.serialize(storedConfigJson);
+
+        json configJson = Config::loadConfig(&configResource, Config::getTrackersDefault(), Config::getTrackersSchema());
+        Config::getTrackersSchema().validate(configJson);
+        EXPECT_EQ(configJson.at("/trackers/86400_2880/sampleCount"_json_pointer), 1440);
+        EXPECT_EQ(configJson.at("/trackers/3600_60/sampleCount"_json_pointer), 60);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(ConfigTest, validatesSelectedOptionOnly)
+{
+    json configJson = Config::getMeasuringDefault();
+    configJson["selected"] = "Simulation";
+    configJson["options"]["Ac"]["pins"]["voltage"] = 4;
+    EXPECT_NO_THROW(Config::getMeasuringSchema().validate(configJson));
+
+    configJson["selected"] = "Ac";
+    EXPECT_THROW(Config::getMeasuringSchema().validate(configJson), std::runtime_error);
+    ExceptionTrace::clear();
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
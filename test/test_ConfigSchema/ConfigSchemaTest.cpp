@@ -0,0 +1,130 @@
+#include "ConfigSchema/ConfigSchema.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+
+
+struct ConfigSchemaTest : public testing::Test
+{
+    ConfigSchema uut = ConfigSchema()
+        .readonly("/version")
+        .oneOf("/selected", {"Ac", "Simulation"})
+        .pin("/options/Ac/pins/voltage", {32, 33, 34, 35, 36, 39})
+        .range("/options/Ac/calibration/voltage", 1, 10000)
+        .integerRange("/trackers/*/sampleCount", 1, 1440);
+
+    json config = {
+        {"version", "0.1.0"},
+        {"selected", "Ac"},
+        {"options", {
+            {"Ac", {
+                {"pins", {{"voltage", 33}}},
+                {"calibration", {{"voltage", 536.9}}},
+            }},
+        }},
+        {"trackers", {
+            {"3600_60", {{"sampleCount", 60}}},
+            {"86400_24", {{"sampleCount", 24}}},
+        }},
+    };
+
+    std::string getError(const json& patch)
+    {
+        json target = config;
+        try
+        {
+            uut.patch(&target, patch);
+        }
+        catch (...)
+        {
+            return ExceptionTrace::what();
+        }
+        return "";
+    }
+};
+
+
+TEST_F(ConfigSchemaTest, patch)
+{
+    try
+    {
+        EXPECT_TRUE(uut.patch(&config, {
+            {"selected", "Simulation"},
+            {"options", {{"Ac", {{"calibration", {{"voltage", 540}}}}}}},
+            {"trackers", {{"86400_24", {{"sampleCount", 48}}}}},
+        }));
+        EXPECT_EQ(config.at("selected"), "Simulation");
+        EXPECT_EQ(config.at("/options/Ac/calibration/voltage"_json_pointer), 540);
+        EXPECT_EQ(config.at("/options/Ac/pins/voltage"_json_pointer), 33);
+        EXPECT_EQ(config.at("/trackers/86400_24/sampleCount"_json_pointer), 48);
+
+        // Unchanged values, readonly ones included, are no change
+        EXPECT_FALSE(uut.patch(&config, {{"version", "0.1.0"}, {"selected", "Simulation"}}));
+
+        EXPECT_TRUE(uut.patch(&config, {{"trackers", {{"3600_60", nullptr}}}}));
+        EXPECT_FALSE(config.at("trackers").contains("3600_60"));
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(ConfigSchemaTest, rejectsInvalidPatches)
+{
+    EXPECT_NE(getError({{"version", "1.0.0"}}).find("\"/version\" is readonly"), std::string::npos);
+    EXPECT_NE(getError({{"foo", 1}}).find("Adding \"/foo\""), std::string::npos);
+    EXPECT_NE(getError({{"selected", 1}}).find("\"/selected\" must be of type string"), std::string::npos);
+    EXPECT_NE(getError({{"selected", "Dc"}}).find("\"/selected\" must be one of"), std::string::npos);
+    EXPECT_NE(
+        getError({{"options", {{"Ac", {{"pins", {{"voltage", 2}}}}}}}}).find("\"/options/Ac/pins/voltage\" is set to 2"),
+        std::string::npos
+    );
+    EXPECT_NE(
+        getError({{"options", {{"Ac", {{"calibration", {{"voltage", 0}}}}}}}}).find("must be within 1 and 10000"),
+        std::string::npos
+    );
+    EXPECT_NE(
+        getError({{"trackers", {{"3600_60", {{"sampleCount", 1.5}}}}}}).find("\"/trackers/3600_60/sampleCount\" must be an integer"),
+        std::string::npos
+    );
+}
+
+
+TEST_F(ConfigSchemaTest, validate)
+{
+    try
+    {
+        uut.validate(config);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+
+    config["trackers"]["86400_24"]["sampleCount"] = 0;
+    EXPECT_ANY_THROW(uut.validate(config));
+    ExceptionTrace::clear();
+}
+
+
+TEST_F(ConfigSchemaTest, clamp)
+{
+    config["options"]["Ac"]["calibration"]["voltage"] = 0.5;
+    config["trackers"]["86400_24"]["sampleCount"] = 2000;
+    json clampedConfig = config;
+
+    EXPECT_TRUE(uut.clamp(&clampedConfig));
+    EXPECT_EQ(clampedConfig.at("/options/Ac/calibration/voltage"_json_pointer), 1);
+    EXPECT_EQ(clampedConfig.at("/trackers/86400_24/sampleCount"_json_pointer), 1440);
+    EXPECT_TRUE(clampedConfig.at("/trackers/86400_24/sampleCount"_json_pointer).is_number_integer());
+    EXPECT_FALSE(uut.clamp(&clampedConfig));
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
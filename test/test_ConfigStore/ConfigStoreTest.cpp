@@ -0,0 +1,126 @@
+#include "ConfigStore/ConfigStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+
+
+struct CountingJsonResource : public MockJsonResource
+{
+    json deserialize() override
+    {
+        readCount++;
+        return MockJsonResource::deserialize();
+    }
+
+    void serialize(const json& data) override
+    {
+        writeCount++;
+        MockJsonResource::serialize(data);
+    }
+
+    size_t readCount = 0;
+    size_t writeCount = 0;
+};
+
+
+struct ConfigStoreTest : public testing::Test
+{
+    CountingJsonResource* resource = new CountingJsonResource();
+    ConfigStore uut = ConfigStore(std::unique_ptr<JsonResource>(resource));
+};
+
+
+TEST_F(ConfigStoreTest, sectionsAreReadOnce)
+{
+    try
+    {
+        resource->serialize({
+            {"Clock", {{"version", "0.0.0"}, {"type", "Simulation"}}},
+            {"Switch", {{"version", "0.0.0"}, {"type", "None"}}},
+        });
+        resource->writeCount = 0;
+        ConfigStore::Section clockSection(&uut, "Clock");
+        ConfigStore::Section switchSection(&uut, "Switch");
+        ConfigStore::Section loggerSection(&uut, "Logger");
+
+        EXPECT_EQ(clockSection.deserialize().at("type"), "Simulation");
+        EXPECT_EQ(switchSection.deserialize().at("type"), "None");
+        EXPECT_EQ(clockSection.deserialize().at("type"), "Simulation");
+        EXPECT_ANY_THROW(loggerSection.deserialize());
+        ExceptionTrace::clear();
+        EXPECT_EQ(loggerSection.deserializeOr(42), 42);
+        EXPECT_EQ(resource->readCount, 1);
+        EXPECT_EQ(switchSection.getGeneration(), 0u);
+
+        switchSection.serialize({{"version", "0.0.0"}, {"type", "Relay"}});
+        EXPECT_EQ(resource->writeCount, 1);
+        EXPECT_EQ(switchSection.getGeneration(), 1u);
+        EXPECT_EQ(clockSection.getGeneration(), 0u);
+        EXPECT_EQ(resource->deserialize().at("Switch").at("type"), "Relay");
+        EXPECT_EQ(resource->deserialize().at("Clock").at("type"), "Simulation");
+
+        switchSection.remove();
+        EXPECT_EQ(switchSection.getGeneration(), 2u);
+        EXPECT_FALSE(uut.hasSection("Switch"));
+        EXPECT_TRUE(uut.hasSection("Clock"));
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(ConfigStoreTest, commitsSeveralSectionsAtOnce)
+{
+    try
+    {
+        uut.commit({
+            {"Clock", {{"type", "DS3231"}}},
+            {"Switch", {{"type", "Relay"}}},
+        });
+        EXPECT_EQ(resource->writeCount, 1);
+        EXPECT_EQ(uut.getSection("Clock").at("type"), "DS3231");
+        EXPECT_EQ(uut.getSection("Switch").at("type"), "Relay");
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(ConfigStoreTest, importsLegacyResources)
+{
+    try
+    {
+        uut.commit({{"Clock", {{"type", "DS3231"}}}});
+        ConfigStore::LegacyResources legacyResources;
+        legacyResources["Clock"].reset(new MockJsonResource());
+        legacyResources["Clock"]->serialize({{"type", "Simulation"}});
+        legacyResources["Switch"].reset(new MockJsonResource());
+        legacyResources["Switch"]->serialize({{"type", "Relay"}});
+
+        resource->writeCount = 0;
+        uut.import(legacyResources);
+        EXPECT_EQ(resource->writeCount, 1);
+        // Sections already in the store are kept
+        EXPECT_EQ(uut.getSection("Clock").at("type"), "DS3231");
+        EXPECT_EQ(uut.getSection("Switch").at("type"), "Relay");
+
+        uut.import(legacyResources);
+        EXPECT_EQ(resource->writeCount, 1);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
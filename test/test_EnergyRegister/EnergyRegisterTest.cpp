@@ -0,0 +1,116 @@
+#include "EnergyRegister/EnergyRegister.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockClock.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+#include <math.h>
+
+
+constexpr time_t checkpointInterval_s = 600;
+
+
+MeasurementFrame getFrame(float activePower_W, uint32_t duration_us = 1000000)
+{
+    return MeasurementFrame(AcPower(230.0f, fabsf(activePower_W) / 230.0f, activePower_W), duration_us);
+}
+
+
+struct EnergyRegisterTest : public testing::Test
+{
+    MockClock mockClock = MockClock(1000);
+    MockJsonResource* storageResource = new MockJsonResource();
+    EnergyRegister uut = EnergyRegister(
+        &mockClock,
+        std::unique_ptr<JsonResource>(storageResource),
+        checkpointInterval_s
+    );
+};
+
+
+TEST_F(EnergyRegisterTest, integratesImportAndExportSeparately)
+{
+    // One hour of 1 kW import and half an hour of 500 W export, in 1 s windows
+    for (size_t i = 0; i < 3600; i++)
+        uut.add(getFrame(1000.0f));
+    for (size_t i = 0; i < 1800; i++)
+        uut.add(getFrame(-500.0f));
+
+    EXPECT_NEAR(uut.getImport_Wh(), 1000.0, 1e-6);
+    EXPECT_NEAR(uut.getExport_Wh(), 250.0, 1e-6);
+}
+
+
+TEST_F(EnergyRegisterTest, keepsEnergyBelowCounterResolution)
+{
+    // 1 W for 20 ms is far below 1 mWh, but must still add up
+    for (size_t i = 0; i < 180000; i++)
+        uut.add(getFrame(1.0f, 20000));
+
+    EXPECT_NEAR(uut.getImport_Wh(), 1.0, 1e-9);
+}
+
+
+TEST_F(EnergyRegisterTest, integratesWindowDuration)
+{
+    // Windows completed after a failed measurement are longer
+    uut.add(getFrame(3600.0f, 1000000));
+    uut.add(MeasurementFrame());
+    uut.add(getFrame(3600.0f, 1500000));
+
+    EXPECT_NEAR(uut.getImport_Wh(), 2.5, 1e-9);
+}
+
+
+TEST_F(EnergyRegisterTest, checkpointsOnBudget)
+{
+    try
+    {
+        uut.add(getFrame(3600.0f));
+        EXPECT_FALSE(uut.checkpoint());
+
+        mockClock.tick(checkpointInterval_s);
+        EXPECT_TRUE(uut.checkpoint());
+        json expectedData = {{"import_mWh", 1000}, {"export_mWh", 0}};
+        EXPECT_EQ(storageResource->deserialize(), expectedData);
+
+        // Nothing changed since the last checkpoint
+        mockClock.tick(checkpointInterval_s);
+        EXPECT_FALSE(uut.checkpoint());
+
+        uut.add(getFrame(-3600.0f));
+        EXPECT_FALSE(uut.checkpoint());
+        EXPECT_TRUE(uut.checkpoint(true));
+        expectedData = {{"import_mWh", 1000}, {"export_mWh", 1000}};
+        EXPECT_EQ(storageResource->deserialize(), expectedData);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(EnergyRegisterTest, restoresCheckpointedCounters)
+{
+    try
+    {
+        std::unique_ptr<MockJsonResource> storedResource(new MockJsonResource());
+        storedResource->serialize({{"import_mWh", 123456789012345ull}, {"export_mWh", 42}});
+        EnergyRegister energyRegister(&mockClock, std::move(storedResource), checkpointInterval_s);
+
+        EXPECT_DOUBLE_EQ(energyRegister.getImport_Wh(), 123456789012.345);
+        EXPECT_DOUBLE_EQ(energyRegister.getExport_Wh(), 0.042);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include "Filesystem/File/PosixFile/PosixFile.h"
+#include "Filesystem/File/RamFile/RamFile.h"
+#include "Filesystem/Directory/PosixDirectory/PosixDirectory.h"
+#include "Filesystem/Directory/RamDirectory/RamDirectory.h"
+#include "JsonResource/BackedUpJsonResource/BackedUpJsonResource.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+
+
+struct RamFilesystem
+{
+    std::unique_ptr<Filesystem::File> getFile(const std::string& path)
+    {
+        return std::unique_ptr<Filesystem::File>(new Filesystem::RamFile(path, storage));
+    }
+
+    std::unique_ptr<Filesystem::Directory> getDirectory(const std::string& path)
+    {
+        return std::unique_ptr<Filesystem::Directory>(new Filesystem::RamDirectory(path, storage));
+    }
+
+    std::string root = "/test";
+    std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+};
+
+
+struct PosixFilesystem
+{
+    PosixFilesystem()
+    {
+        char rootTemplate[] = "/tmp/FilesystemTest.XXXXXX";
+        root = mkdtemp(rootTemplate);
+    }
+
+    ~PosixFilesystem()
+    {
+        Filesystem::PosixDirectory directory(root);
+        if (directory.exists())
+            directory.remove();
+    }
+
+    std::unique_ptr<Filesystem::File> getFile(const std::string& path)
+    {
+        return std::unique_ptr<Filesystem::File>(new Filesystem::PosixFile(path));
+    }
+
+    std::unique_ptr<Filesystem::Directory> getDirectory(const std::string& path)
+    {
+        return std::unique_ptr<Filesystem::Directory>(new Filesystem::PosixDirectory(path));
+    }
+
+    std::string root;
+};
+
+
+template<typename T>
+struct FilesystemTest : public testing::Test
+{
+    T filesystem;
+};
+
+using Filesystems = testing::Types<RamFilesystem, PosixFilesystem>;
+TYPED_TEST_SUITE(FilesystemTest, Filesystems);
+
+
+TYPED_TEST(FilesystemTest, fileBehavesLikeFstream)
+{
+    try
+    {
+        std::unique_ptr<Filesystem::File> file = this->filesystem.getFile(this->filesystem.root + "/Config/a.json");
+        EXPECT_FALSE(file->exists());
+        EXPECT_THROW(file->open(std::ios::in), std::runtime_error);
+
+        *file->open(std::ios::out) << "Hello World";
+        EXPECT_TRUE(file->exists());
+        EXPECT_TRUE(this->filesystem.getDirectory(this->filesystem.root + "/Config")->exists());
+        EXPECT_EQ(file->getName(), "a.json");
+
+        {
+            Filesystem::File::Stream stream = file->open(std::ios::in | std::ios::out);
+            stream->seekp(6);
+            *stream << "Flash";
+        }
+        std::string content;
+        std::getline(*file->open(std::ios::in), content);
+        EXPECT_EQ(content, "Hello Flash");
+
+        *file->open(std::ios::out) << "Bye";
+        std::getline(*file->open(std::ios::in), content);
+        EXPECT_EQ(content, "Bye");
+        EXPECT_GT(file->getLastWriteTimestamp(), 0);
+
+        file->remove();
+        EXPECT_FALSE(file->exists());
+        EXPECT_THROW(file->remove(), std::runtime_error);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TYPED_TEST(FilesystemTest, directoryListsAndRemovesEntries)
+{
+    try
+    {
+        const std::string& root = this->filesystem.root;
+        this->filesystem.getDirectory(root + "/Trackers/empty")->create();
+        *this->filesystem.getFile(root + "/Trackers/day/data.bin")->open(std::ios::out) << "data";
+        *this->filesystem.getFile(root + "/Trackers/readme.txt")->open(std::ios::out) << "text";
+
+        std::unique_ptr<Filesystem::Directory> trackers = this->filesystem.getDirectory(root + "/Trackers");
+        std::vector<std::string> paths;
+        for (const auto& entry : trackers->getEntries())
+            paths.push_back(entry->getPath());
+        EXPECT_EQ(paths, std::vector<std::string>({
+            root + "/Trackers/day",
+            root + "/Trackers/empty",
+            root + "/Trackers/readme.txt",
+        }));
+        json trackersJson = trackers->toJson();
+        EXPECT_EQ(trackersJson.at("children").at(0).at("type"), "Directory");
+        EXPECT_EQ(trackersJson.at("children").at(0).at("children").at(0).at("name"), "data.bin");
+
+        trackers->remove();
+        EXPECT_FALSE(trackers->exists());
+        EXPECT_FALSE(this->filesystem.getFile(root + "/Trackers/day/data.bin")->exists());
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TYPED_TEST(FilesystemTest, backedUpJsonResourceSurvivesReopening)
+{
+    try
+    {
+        const std::string& root = this->filesystem.root;
+        const json configJson = {{"version", "1.0.0"}, {"value", 42}};
+        {
+            BackedUpJsonResource resource(
+                BasicJsonResource(this->filesystem.getFile(root + "/Config/Test.a.json")),
+                BasicJsonResource(this->filesystem.getFile(root + "/Config/Test.b.json"))
+            );
+            resource.serialize(configJson);
+        }
+        BackedUpJsonResource reopenedResource(
+            BasicJsonResource(this->filesystem.getFile(root + "/Config/Test.a.json")),
+            BasicJsonResource(this->filesystem.getFile(root + "/Config/Test.b.json"))
+        );
+        EXPECT_EQ(reopenedResource.deserialize(), configJson);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(RamStorageTest, countsWrites)
+{
+    std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+    Filesystem::RamFile file("/Energy/Register.a.json", storage);
+    *file.open(std::ios::out) << "12345";
+    file.open(std::ios::in);
+    *file.open(std::ios::out) << "123";
+    EXPECT_EQ(storage->getWriteCount(), 2);
+    EXPECT_EQ(storage->getWrittenSize_B(), 8);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
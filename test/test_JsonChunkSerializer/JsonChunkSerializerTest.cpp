@@ -0,0 +1,68 @@
+#include "JsonChunkSerializer/JsonChunkSerializer.h"
+
+#include <gtest/gtest.h>
+
+
+std::shared_ptr<const json> getTrackersJson()
+{
+    json trackersJson;
+    for (const char* id : {"minute", "hour", "day"})
+    {
+        json::array_t data;
+        for (size_t i = 0; i < 300; i++)
+            data.push_back(i % 7 == 0 ? json() : json(i * 0.37));
+        trackersJson[id] = {
+            {"title", std::string("Last ") + id + " \"äöü\"\n"},
+            {"sampleCount", 300},
+            {"empty", {{"object", json::object()}, {"array", json::array()}}},
+            {"data", data},
+        };
+    }
+    return std::make_shared<const json>(std::move(trackersJson));
+}
+
+
+std::string readAll(JsonChunkSerializer& uut, size_t chunkSize)
+{
+    std::string output;
+    std::vector<char> buffer(chunkSize);
+    while (size_t size = uut.read(buffer.data(), buffer.size()))
+    {
+        EXPECT_LE(size, chunkSize);
+        output.append(buffer.data(), size);
+    }
+    return output;
+}
+
+
+TEST(JsonChunkSerializerTest, matchesDump)
+{
+    std::shared_ptr<const json> dataJson = getTrackersJson();
+    for (int indent : {-1, 0, 1, 4})
+    {
+        for (size_t chunkSize : {1, 7, 256, 100000})
+        {
+            JsonChunkSerializer uut(dataJson, indent, '\t');
+            EXPECT_EQ(readAll(uut, chunkSize), dataJson->dump(indent, '\t'));
+            char character;
+            EXPECT_EQ(uut.read(&character, 1), 0);
+        }
+    }
+}
+
+
+TEST(JsonChunkSerializerTest, scalarsAndEmptyContainers)
+{
+    for (const json& dataJson : {json(42), json("text"), json(), json::object(), json::array(), json({json::array()})})
+    {
+        JsonChunkSerializer uut(std::make_shared<const json>(dataJson), 2);
+        EXPECT_EQ(readAll(uut, 3), dataJson.dump(2));
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
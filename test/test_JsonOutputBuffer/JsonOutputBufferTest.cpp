@@ -0,0 +1,103 @@
+#include "JsonOutputBuffer/JsonOutputBuffer.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <new>
+#include <sstream>
+#include <stdlib.h>
+
+
+// Counts the heap allocated while serializing
+std::atomic<size_t> allocatedSize_B(0);
+
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    allocatedSize_B += size;
+    void* pointer = malloc(size);
+    if (pointer == nullptr)
+        throw std::bad_alloc();
+    return pointer;
+}
+
+
+__attribute__((noinline)) void operator delete(void* pointer) noexcept
+{
+    free(pointer);
+}
+
+
+__attribute__((noinline)) void operator delete(void* pointer, size_t) noexcept
+{
+    free(pointer);
+}
+
+
+json getTrackersJson()
+{
+    json trackersJson;
+    for (const char* id : {"minute", "hour", "day", "month", "year"})
+    {
+        json::array_t data;
+        for (size_t i = 0; i < 1000; i++)
+            data.push_back(i % 7 == 0 ? json() : json(i * 0.37));
+        trackersJson[id] = {
+            {"title", std::string("Last ") + id + " \"äöü\"\n"},
+            {"data", data},
+        };
+    }
+    return trackersJson;
+}
+
+
+TEST(JsonOutputBufferTest, matchesDump)
+{
+    json dataJson = getTrackersJson();
+    for (int indent : {-1, 0, 1, 4})
+    {
+        std::string output;
+        size_t sinkCallCount = 0;
+        JsonOutputBuffer::serialize(dataJson, [&](const char* data, size_t size){
+            EXPECT_GT(size, 0);
+            EXPECT_LE(size, JsonOutputBuffer::size_B);
+            output.append(data, size);
+            sinkCallCount++;
+        }, indent, '\t');
+        EXPECT_EQ(output, dataJson.dump(indent, '\t'));
+        EXPECT_EQ(sinkCallCount, (output.size() + JsonOutputBuffer::size_B - 1) / JsonOutputBuffer::size_B);
+    }
+
+    std::stringstream stream;
+    JsonOutputBuffer::serialize(json(42), stream);
+    EXPECT_EQ(stream.str(), "42");
+}
+
+
+TEST(JsonOutputBufferTest, heapUseDoesNotGrowWithDocument)
+{
+    json dataJson = getTrackersJson();
+    std::string reference = dataJson.dump();
+    ASSERT_GT(reference.size(), 20000);
+
+    size_t outputSize_B = 0;
+    size_t allocatedBefore_B = allocatedSize_B;
+    JsonOutputBuffer::serialize(dataJson, [&](const char*, size_t size){
+        outputSize_B += size;
+    });
+    size_t streamingAllocated_B = allocatedSize_B - allocatedBefore_B;
+
+    allocatedBefore_B = allocatedSize_B;
+    std::string dumped = dataJson.dump();
+    size_t dumpAllocated_B = allocatedSize_B - allocatedBefore_B;
+
+    EXPECT_EQ(outputSize_B, reference.size());
+    EXPECT_LT(streamingAllocated_B, 1024);
+    EXPECT_GE(dumpAllocated_B, reference.size());
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,51 @@
+#include "MeasurementFrame/MeasurementFrame.h"
+
+#include <gtest/gtest.h>
+
+
+TEST(MeasurementFrameTest, getValues)
+{
+    MeasurementFrame uut(AcPower(230.0f, 1.0f, 100.0f));
+    EXPECT_TRUE(uut.isValid());
+    EXPECT_FLOAT_EQ(uut.getActivePower_W(), 100.0f);
+    EXPECT_FLOAT_EQ(uut.getApparentPower_VA(), 230.0f);
+    EXPECT_FLOAT_EQ(uut.getReactivePower_var(), 207.12315f);
+    EXPECT_FLOAT_EQ(uut.getVoltage_V(), 230.0f);
+    EXPECT_FLOAT_EQ(uut.getCurrent_A(), 1.0f);
+    EXPECT_FLOAT_EQ(uut.get(Quantity::PowerFactor), 0.43478259f);
+    EXPECT_STREQ(MeasurementFrame::getInfo(Quantity::ReactivePower).unit, "var");
+    EXPECT_EQ(MeasurementFrame::getInfo(Quantity::Current).fractionDigits, 1);
+}
+
+
+TEST(MeasurementFrameTest, keepsSignedPowerAndDuration)
+{
+    MeasurementFrame uut(AcPower(230.0f, 1.0f, -100.0f), 1000000);
+    EXPECT_FLOAT_EQ(uut.getActivePower_W(), 0.0f);
+    EXPECT_FLOAT_EQ(uut.getSignedActivePower_W(), -100.0f);
+    EXPECT_EQ(uut.getDuration_us(), 1000000);
+}
+
+
+TEST(MeasurementFrameTest, toJson)
+{
+    EXPECT_EQ(MeasurementFrame().toJson(), json::array());
+
+    json frameJson = MeasurementFrame(AcPower(230.0f, 1.0f, 100.0f)).toJson();
+    ASSERT_EQ(frameJson.size(), MeasurementFrame::quantityCount);
+    EXPECT_EQ(frameJson.front(), json({
+        {"name", "Active Power"},
+        {"value", 100.0f},
+        {"unit", "W"},
+        {"fractionDigits", 0},
+    }));
+    EXPECT_EQ(frameJson.back().at("name"), "Power Factor");
+    EXPECT_EQ(frameJson.back().at("fractionDigits"), 2);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+#include "Rtos/PublishedValue/PublishedValue.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <string>
+#include <thread>
+
+
+TEST(PublishedValueTest, readersKeepTheirSnapshot)
+{
+    Rtos::PublishedValue<std::string> uut;
+    EXPECT_EQ(*uut.get(), "");
+    EXPECT_EQ(uut.getGeneration(), 0u);
+
+    uut.publish("first");
+    std::shared_ptr<const std::string> snapshot = uut.get();
+    uut.publish("second");
+
+    EXPECT_EQ(*snapshot, "first");
+    EXPECT_EQ(*uut.get(), "second");
+    EXPECT_EQ(uut.getGeneration(), 2u);
+}
+
+
+TEST(PublishedValueTest, readersSeeCompleteValuesWhilePublishing)
+{
+    Rtos::PublishedValue<std::string> uut;
+    uut.publish(std::string(64, 'a'));
+    std::atomic<bool> isDone(false);
+    std::thread writer([&]{
+        for (size_t i = 0; i < 10000; i++)
+            uut.publish(std::string(64, 'a' + i % 26));
+        isDone = true;
+    });
+
+    while (!isDone)
+    {
+        std::shared_ptr<const std::string> value = uut.get();
+        ASSERT_EQ(value->size(), 64u);
+        ASSERT_EQ(value->find_first_not_of(value->front()), std::string::npos);
+    }
+    writer.join();
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include "RouteTrie/RouteTrie.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+
+#include <gtest/gtest.h>
+
+
+constexpr RouteTrie::Methods get = 0b001;
+constexpr RouteTrie::Methods post = 0b010;
+constexpr RouteTrie::Methods patch = 0b100;
+
+
+struct RouteTrieTest : public testing::Test
+{
+    RouteTrieTest()
+    {
+        uut.add("/trackers", get, 0);
+        uut.add("/trackers", patch | post, 1);
+        uut.add("/trackers/config", get, 2);
+        uut.add("/trackers/{id}", get, 3);
+        uut.add("/trackers/{id}/samples/{index}", get, 4);
+        uut.add("/files/{path*}", get, 5);
+    }
+
+    RouteTrie uut;
+};
+
+
+TEST_F(RouteTrieTest, matchesLiterals)
+{
+    EXPECT_EQ(uut.match("/trackers", get)->handlerId, 0);
+    EXPECT_EQ(uut.match("/trackers/", post)->handlerId, 1);
+    EXPECT_EQ(uut.match("trackers", patch)->handlerId, 1);
+    EXPECT_EQ(uut.match("/trackers/config", get)->handlerId, 2);
+    EXPECT_FALSE(uut.match("/trackers/config", post).has_value());
+    EXPECT_FALSE(uut.match("/tracker", get).has_value());
+    EXPECT_FALSE(uut.match("/", get).has_value());
+}
+
+
+TEST_F(RouteTrieTest, capturesParameters)
+{
+    try
+    {
+        tl::optional<RouteTrie::Match> match = uut.match("/trackers/3600_60", get);
+        ASSERT_TRUE(match.has_value());
+        EXPECT_EQ(match->handlerId, 3);
+        EXPECT_EQ(match->params.get("id"), "3600_60");
+
+        match = uut.match("/trackers/3600_60/samples/42", get);
+        ASSERT_TRUE(match.has_value());
+        EXPECT_EQ(match->handlerId, 4);
+        EXPECT_EQ(match->params.get("id"), "3600_60");
+        EXPECT_EQ(match->params.get<int>("index"), 42);
+        EXPECT_FALSE(match->params.has("path"));
+
+        match = uut.match("/files/History/power.tss", get);
+        ASSERT_TRUE(match.has_value());
+        EXPECT_EQ(match->handlerId, 5);
+        EXPECT_EQ(match->params.get("path"), "History/power.tss");
+        EXPECT_EQ(uut.match("/files", get)->params.get("path"), "");
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+
+    EXPECT_ANY_THROW(uut.match("/trackers/3600_60/samples/4x", get)->params.get<int>("index"));
+    EXPECT_ANY_THROW(uut.match("/trackers/3600_60", get)->params.get("index"));
+    ExceptionTrace::clear();
+}
+
+
+TEST_F(RouteTrieTest, rejectsInvalidPatterns)
+{
+    EXPECT_ANY_THROW(uut.add("/trackers", get | patch, 6));
+    EXPECT_ANY_THROW(uut.add("/files/{path*}/foo", get, 6));
+    ExceptionTrace::clear();
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
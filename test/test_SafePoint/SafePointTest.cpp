@@ -0,0 +1,72 @@
+#include "Rtos/SafePoint/SafePoint.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+
+struct SafePointTest : public testing::Test
+{
+    void SetUp() override
+    {
+        owner = std::thread([this]{
+            while (!isDone)
+            {
+                // The resource is only used by the owner, in between the safe points
+                ownedValue++;
+                uut.pass();
+                std::this_thread::yield();
+            }
+        });
+    }
+
+    void TearDown() override
+    {
+        isDone = true;
+        owner.join();
+    }
+
+    Rtos::SafePoint uut;
+    std::thread owner;
+    std::atomic<bool> isDone = {false};
+    size_t ownedValue = 0;
+};
+
+
+TEST_F(SafePointTest, runsOnTheOwningTask)
+{
+    std::thread::id ownerId;
+    uut.run([&]{
+        ownerId = std::this_thread::get_id();
+        ownedValue = 0;
+    });
+    EXPECT_EQ(ownerId, owner.get_id());
+
+    size_t valueSeen = 0;
+    uut.run([&]{
+        valueSeen = ownedValue;
+    });
+    EXPECT_GT(valueSeen, 0u);
+}
+
+
+TEST_F(SafePointTest, passesExceptionsToTheCaller)
+{
+    EXPECT_THROW(uut.run([]{
+        throw std::runtime_error("Failed");
+    }), std::runtime_error);
+
+    bool isRun = false;
+    uut.run([&]{
+        isRun = true;
+    });
+    EXPECT_TRUE(isRun);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
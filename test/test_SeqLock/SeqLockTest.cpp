@@ -0,0 +1,66 @@
+#include "Rtos/SeqLock/SeqLock.h"
+#include "MeasurementFrame/MeasurementFrame.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+
+struct Record
+{
+    uint32_t sequence;
+    float values[15];
+};
+
+
+TEST(SeqLockTest, loadReturnsStoredValue)
+{
+    Rtos::SeqLock<MeasurementFrame> uut;
+    EXPECT_FALSE(uut.load().isValid());
+    EXPECT_EQ(uut.getGeneration(), 0u);
+
+    uut.store(MeasurementFrame(AcPower(230.0f, 1.0f, 42.0f)));
+    MeasurementFrame measurements = uut.load();
+    ASSERT_TRUE(measurements.isValid());
+    EXPECT_EQ(measurements.getActivePower_W(), 42.0f);
+    EXPECT_EQ(measurements.getVoltage_V(), 230.0f);
+    EXPECT_EQ(uut.getGeneration(), 1u);
+    EXPECT_EQ(uut.getRetryCount(), 0u);
+}
+
+
+TEST(SeqLockTest, readersNeverSeeTornValues)
+{
+    Rtos::SeqLock<Record> uut;
+    std::atomic<bool> isDone(false);
+    std::thread writer([&]{
+        Record record = {};
+        for (uint32_t i = 1; i <= 200000; i++)
+        {
+            record.sequence = i;
+            for (float& value : record.values)
+                value = i;
+            uut.store(record);
+        }
+        isDone = true;
+    });
+
+    uint32_t lastSequence = 0;
+    while (!isDone)
+    {
+        Record record = uut.load();
+        ASSERT_GE(record.sequence, lastSequence);
+        for (float value : record.values)
+            ASSERT_EQ(value, static_cast<float>(record.sequence));
+        lastSequence = record.sequence;
+    }
+    writer.join();
+    EXPECT_EQ(uut.load().sequence, 200000u);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
\ No newline at end of file
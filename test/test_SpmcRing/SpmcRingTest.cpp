@@ -0,0 +1,137 @@
+#include "SpmcRing/SpmcRing.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+using Ring = SpmcRing<uint32_t, 8>;
+
+
+TEST(SpmcRingTest, cursorsReadIndependently)
+{
+    Ring uut;
+    Ring::Cursor first = uut.getCursor();
+    Ring::Cursor second = uut.getCursor();
+    uint32_t value;
+
+    EXPECT_FALSE(uut.pop(first, value));
+    uut.push(1);
+    uut.push(2);
+
+    EXPECT_TRUE(uut.pop(first, value));
+    EXPECT_EQ(1, value);
+    EXPECT_TRUE(uut.pop(first, value));
+    EXPECT_EQ(2, value);
+    EXPECT_FALSE(uut.pop(first, value));
+
+    EXPECT_TRUE(uut.pop(second, value));
+    EXPECT_EQ(1, value);
+}
+
+
+TEST(SpmcRingTest, slowCursorSkipsOverwrittenValues)
+{
+    Ring uut;
+    Ring::Cursor cursor = uut.getCursor();
+    for (uint32_t i = 0; i < 20; i++)
+        uut.push(i);
+
+    uint32_t value;
+    EXPECT_TRUE(uut.pop(cursor, value));
+    EXPECT_EQ(12, value);
+    EXPECT_EQ(12, cursor.getDroppedCount());
+
+    std::vector<uint32_t> rest;
+    while (uut.pop(cursor, value))
+        rest.push_back(value);
+    EXPECT_EQ(std::vector<uint32_t>({13, 14, 15, 16, 17, 18, 19}), rest);
+}
+
+
+TEST(SpmcRingTest, cursorAtPositionIsClamped)
+{
+    Ring uut;
+    for (uint32_t i = 0; i < 20; i++)
+        uut.push(i);
+
+    EXPECT_EQ(12, uut.getCursor(0).getPosition());
+    EXPECT_EQ(15, uut.getCursor(15).getPosition());
+    EXPECT_EQ(20, uut.getCursor().getPosition());
+}
+
+
+TEST(SpmcRingTest, cursorAheadOfHeadIsClamped)
+{
+    Ring uut;
+    for (uint32_t i = 0; i < 5; i++)
+        uut.push(i);
+
+    Ring::Cursor cursor = uut.getCursor(1000);
+    EXPECT_EQ(5, cursor.getPosition());
+    uint32_t value;
+    EXPECT_FALSE(uut.pop(cursor, value));
+    EXPECT_EQ(0, cursor.getDroppedCount());
+
+    uut.push(5);
+    EXPECT_TRUE(uut.pop(cursor, value));
+    EXPECT_EQ(5, value);
+    EXPECT_EQ(0, cursor.getDroppedCount());
+
+    // Before the oldest value, like since=-1, starts at the oldest value instead
+    cursor = uut.getCursor(UINT32_MAX);
+    EXPECT_EQ(0, cursor.getPosition());
+    EXPECT_TRUE(uut.pop(cursor, value));
+    EXPECT_EQ(0, value);
+    EXPECT_EQ(0, cursor.getDroppedCount());
+}
+
+
+TEST(SpmcRingTest, concurrentReadersNeverSeeTornValues)
+{
+    struct Value
+    {
+        uint64_t number;
+        uint64_t inverted;
+    };
+    SpmcRing<Value, 16> uut;
+    std::atomic<bool> done(false);
+    constexpr uint64_t count = 200000;
+
+    auto read = [&uut, &done, count]{
+        SpmcRing<Value, 16>::Cursor cursor = uut.getCursor(0);
+        uint64_t last = 0;
+        Value value;
+        while (true)
+        {
+            bool isDone = done;
+            if (uut.pop(cursor, value))
+            {
+                EXPECT_EQ(~value.number, value.inverted);
+                EXPECT_LT(last, value.number);
+                last = value.number;
+            }
+            else if (isDone)
+            {
+                break;
+            }
+        }
+        EXPECT_EQ(count, last);
+    };
+
+    std::thread firstReader(read);
+    std::thread secondReader(read);
+    for (uint64_t i = 1; i <= count; i++)
+        uut.push(Value {i, ~i});
+    done = true;
+    firstReader.join();
+    secondReader.join();
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
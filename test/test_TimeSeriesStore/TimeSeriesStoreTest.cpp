@@ -0,0 +1,250 @@
+#include "TimeSeriesStore/TimeSeriesStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "Filesystem/Directory/RamDirectory/RamDirectory.h"
+#include "Filesystem/File/RamFile/RamFile.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <fstream>
+#include <math.h>
+#include <stdlib.h>
+#include <random>
+
+
+constexpr uint32_t maxChunkCount = 8;
+const std::string directoryPath = "/History/power";
+
+
+TimeSeriesStore createStore(std::shared_ptr<Filesystem::RamStorage> storage, uint32_t maxChunkCount = ::maxChunkCount)
+{
+    return TimeSeriesStore(
+        std::unique_ptr<Filesystem::Directory>(new Filesystem::RamDirectory(directoryPath, storage)),
+        [storage](const std::string& path){
+            return std::unique_ptr<Filesystem::File>(new Filesystem::RamFile(path, storage));
+        },
+        maxChunkCount
+    );
+}
+
+
+// Per minute average power of a household: base load, fridge cycling, cooking peaks and a midday PV feed in.
+// Set POWERMETER_TRACE to a CSV file with "timestamp,power" lines to benchmark a recorded trace instead.
+std::vector<GorillaChunk::Point> getTrace(size_t days)
+{
+    std::vector<GorillaChunk::Point> points;
+    const char* tracePath = getenv("POWERMETER_TRACE");
+    if (tracePath != nullptr)
+    {
+        std::ifstream traceFile(tracePath);
+        int64_t timestamp;
+        char separator;
+        float value;
+        while (traceFile >> timestamp >> separator >> value)
+            points.push_back({timestamp, value});
+        return points;
+    }
+
+    std::mt19937 random(42);
+    std::normal_distribution<float> noise(0, 3);
+    int64_t timestamp = 1700000000 / 60 * 60;
+    for (size_t minute = 0; minute < days * 24 * 60; minute++)
+    {
+        float minuteOfDay = minute % (24 * 60);
+        float power = 120 + noise(random);
+        if (minute % 45 < 15)
+            power += 90;
+        if ((minuteOfDay > 7 * 60 && minuteOfDay < 7.5 * 60) || (minuteOfDay > 18 * 60 && minuteOfDay < 19 * 60))
+            power += 2000;
+        float sun = sinf((minuteOfDay - 6 * 60) / (12 * 60) * M_PI);
+        if (sun > 0)
+            power -= 800 * sun;
+        // Averages are rounded to 0.1 W, like the displayed values
+        points.push_back({timestamp + static_cast<int64_t>(minute) * 60, roundf(power * 10) / 10});
+    }
+    return points;
+}
+
+
+TEST(GorillaChunkTest, roundTrip)
+{
+    GorillaChunk chunk;
+    std::vector<GorillaChunk::Point> points = {
+        {-5, 0.0f},
+        {0, 0.0f},
+        {60, 230.5f},
+        {120, 230.5f},
+        {181, -1500.25f},
+        {100000, NAN},
+        {100001, INFINITY},
+        {INT32_MAX, 1e-30f},
+    };
+    for (const auto& point : points)
+        ASSERT_TRUE(chunk.append(point));
+    EXPECT_FALSE(chunk.append({INT32_MAX, 0.0f}));
+
+    std::vector<GorillaChunk::Point> decodedPoints = chunk.decode();
+    ASSERT_EQ(decodedPoints.size(), points.size());
+    for (size_t i = 0; i < points.size(); i++)
+    {
+        EXPECT_EQ(decodedPoints[i].timestamp, points[i].timestamp);
+        EXPECT_EQ(memcmp(&decodedPoints[i].value, &points[i].value, sizeof(float)), 0);
+    }
+
+    GorillaChunk loadedChunk;
+    ASSERT_TRUE(loadedChunk.load(chunk.getData(), chunk.getBitCount(), chunk.getCount()));
+    EXPECT_TRUE(loadedChunk.append({INT32_MAX + 60ll, 1.0f}));
+    EXPECT_TRUE(chunk.append({INT32_MAX + 60ll, 1.0f}));
+    EXPECT_EQ(memcmp(loadedChunk.getData(), chunk.getData(), chunk.getSize_B()), 0);
+    EXPECT_FALSE(loadedChunk.load(chunk.getData(), chunk.getBitCount(), chunk.getCount() + 1));
+}
+
+
+TEST(GorillaChunkTest, refusesPointsWhenFull)
+{
+    GorillaChunk chunk;
+    std::mt19937 random(1);
+    size_t count = 0;
+    while (chunk.append({static_cast<int64_t>(count * count), static_cast<float>(random())}))
+        count++;
+    EXPECT_LE(chunk.getSize_B(), GorillaChunk::capacity_B);
+    EXPECT_EQ(chunk.decode().size(), count);
+}
+
+
+TEST(TimeSeriesStoreTest, appendFlushAndReopen)
+{
+    try
+    {
+        std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+        TimeSeriesStore uut = createStore(storage);
+        std::vector<GorillaChunk::Point> points = getTrace(3);
+        for (const auto& point : points)
+            ASSERT_TRUE(uut.append(point.timestamp, point.value));
+        EXPECT_FALSE(uut.append(points.back().timestamp, 0));
+        EXPECT_EQ(uut.getStatistics().at("rejectedCount"), 1);
+        uut.flush();
+        size_t chunkCount = uut.getChunkCount();
+        EXPECT_GT(chunkCount, 1);
+        EXPECT_LT(chunkCount, maxChunkCount);
+        EXPECT_EQ(storage->getChildren(directoryPath).size(), chunkCount);
+
+        TimeSeriesStore reopened = createStore(storage);
+        EXPECT_EQ(reopened.getChunkCount(), chunkCount);
+        EXPECT_FALSE(reopened.append(points.back().timestamp, 0));
+        ASSERT_TRUE(reopened.append(points.back().timestamp + 60, 1));
+
+        std::vector<GorillaChunk::Point> readPoints = reopened.read(INT64_MIN, INT64_MAX);
+        ASSERT_EQ(readPoints.size(), points.size() + 1);
+        for (size_t i = 0; i < points.size(); i++)
+        {
+            EXPECT_EQ(readPoints[i].timestamp, points[i].timestamp);
+            EXPECT_EQ(readPoints[i].value, points[i].value);
+        }
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(TimeSeriesStoreTest, removesOldestChunkAndReadsRange)
+{
+    try
+    {
+        std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+        TimeSeriesStore uut = createStore(storage);
+        std::vector<GorillaChunk::Point> points = getTrace(30);
+        for (const auto& point : points)
+            ASSERT_TRUE(uut.append(point.timestamp, point.value));
+
+        EXPECT_EQ(uut.getChunkCount(), maxChunkCount);
+        // The open chunk is not written yet
+        std::vector<Filesystem::RamStorage::Child> children = storage->getChildren(directoryPath);
+        EXPECT_EQ(children.size(), maxChunkCount - 1);
+        for (const auto& child : children)
+            EXPECT_LE(storage->readFile(directoryPath + '/' + child.name)->content.size(), TimeSeriesStore::chunkFileSize_B);
+        int64_t firstTimestamp = uut.getChunkInfo(0).firstTimestamp;
+        EXPECT_GT(firstTimestamp, points.front().timestamp);
+        for (size_t i = 1; i < uut.getChunkCount(); i++)
+            EXPECT_EQ(uut.getChunkInfo(i).sequence, uut.getChunkInfo(i - 1).sequence + 1);
+
+        int64_t from = points[points.size() - 1000].timestamp + 1;
+        int64_t to = points[points.size() - 10].timestamp;
+        std::vector<GorillaChunk::Point> readPoints = uut.read(from, to);
+        ASSERT_EQ(readPoints.size(), 990);
+        EXPECT_EQ(readPoints.front().timestamp, points[points.size() - 999].timestamp);
+        EXPECT_EQ(readPoints.back().timestamp, to);
+        EXPECT_TRUE(uut.read(0, firstTimestamp - 1).empty());
+        EXPECT_EQ(uut.read(from, to, 5).back().timestamp, readPoints[4].timestamp);
+
+        // Chunks beyond a lowered maximum count are removed when opening
+        uut.flush();
+        TimeSeriesStore reopened = createStore(storage, 4);
+        EXPECT_EQ(reopened.getChunkCount(), 4);
+        EXPECT_EQ(storage->getChildren(directoryPath).size(), 4);
+        EXPECT_EQ(reopened.read(INT64_MIN, INT64_MAX).back().timestamp, points.back().timestamp);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST(TimeSeriesStoreTest, corruptedChunkIsNotRead)
+{
+    std::shared_ptr<Filesystem::RamStorage> storage = std::make_shared<Filesystem::RamStorage>();
+    TimeSeriesStore uut = createStore(storage);
+    for (const auto& point : getTrace(3))
+        uut.append(point.timestamp, point.value);
+    uut.flush();
+
+    std::string content = storage->readFile(directoryPath + "/0.chunk")->content;
+    content[100] ^= 0x01;
+    storage->writeFile(directoryPath + "/0.chunk", content);
+    EXPECT_THROW(uut.readChunk(0), std::runtime_error);
+    ExceptionTrace::clear();
+}
+
+
+TEST(TimeSeriesStoreTest, benchmark)
+{
+    std::vector<GorillaChunk::Point> points = getTrace(365);
+    ASSERT_FALSE(points.empty());
+
+    std::vector<GorillaChunk> chunks(1);
+    auto encodeStart = std::chrono::steady_clock::now();
+    for (const auto& point : points)
+    {
+        if (!chunks.back().append(point))
+        {
+            chunks.emplace_back();
+            ASSERT_TRUE(chunks.back().append(point));
+        }
+    }
+    auto encodeEnd = std::chrono::steady_clock::now();
+
+    size_t decodedCount = 0;
+    for (const auto& chunk : chunks)
+        decodedCount += chunk.decode().size();
+    auto decodeEnd = std::chrono::steady_clock::now();
+    ASSERT_EQ(decodedCount, points.size());
+
+    double size_B = chunks.size() * TimeSeriesStore::chunkFileSize_B;
+    double encode_s = std::chrono::duration<double>(encodeEnd - encodeStart).count();
+    double decode_s = std::chrono::duration<double>(decodeEnd - encodeEnd).count();
+    std::cout
+        << points.size() << " points in " << chunks.size() << " chunks, "
+        << size_B / points.size() << " B/point (uncompressed 12 B/point), "
+        << points.size() / encode_s << " points/s encoding, "
+        << points.size() / decode_s << " points/s decoding" << std::endl;
+    EXPECT_LT(size_B / points.size(), 6);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
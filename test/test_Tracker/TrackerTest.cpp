@@ -1,4 +1,5 @@
 #include "Tracker/Tracker.h"
+#include "TrackerStore/JsonTrackerStore/JsonTrackerStore.h"
 #include "ExceptionTrace/ExceptionTrace.h"
 #include "MockClock.h"
 #include "MockJsonResource.h"
@@ -28,7 +29,7 @@ struct TrackerTest : public testing::Test
         duration_s,
         sampleCount,
         &mockClock,
-        std::make_unique<MockJsonResource>(),
+        std::make_unique<JsonTrackerStore>(std::make_unique<MockJsonResource>(), sampleCount),
         std::make_unique<MockJsonResource>(),
         std::make_unique<MockJsonResource>(),
         AverageAccumulator(std::make_unique<MockJsonResource>())
@@ -141,6 +142,45 @@ TEST_F(TrackerTest, shouldFillWithZeroWhilePowerDown)
 }
 
 
+TEST_F(TrackerTest, shouldWriteBehindUntilCheckpointIsDue)
+{
+    try
+    {
+        MockJsonResource* lastInputResource = new MockJsonResource();
+        MockJsonResource* accumulatorResource = new MockJsonResource();
+        Tracker tracker(
+            "Write Behind Tracker",
+            duration_s,
+            sampleCount,
+            &mockClock,
+            std::make_unique<JsonTrackerStore>(std::make_unique<MockJsonResource>(), sampleCount),
+            std::unique_ptr<JsonResource>(lastInputResource),
+            std::make_unique<MockJsonResource>(),
+            AverageAccumulator(std::unique_ptr<JsonResource>(accumulatorResource)),
+            Tracker::CheckpointPolicy{.interval_s = 30, .maxUnsavedInputCount = 1000}
+        );
+
+        tracker.track(1.0f);
+        json checkpointedInput = lastInputResource->deserialize();
+        for (size_t i = 0; i < 29; i++)
+        {
+            mockClock.tick();
+            tracker.track(1.0f);
+            EXPECT_EQ(lastInputResource->deserialize(), checkpointedInput);
+        }
+
+        mockClock.tick();
+        tracker.track(1.0f);
+        EXPECT_EQ(lastInputResource->deserialize(), mockClock.now());
+        EXPECT_EQ(accumulatorResource->deserialize().at("count"), 30);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
 int main()
 {
     testing::InitGoogleTest();
@@ -0,0 +1,148 @@
+#include "TrackerCascade/TrackerCascade.h"
+#include "TrackerStore/JsonTrackerStore/JsonTrackerStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockClock.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+
+
+struct TrackerCascadeTest : public testing::Test
+{
+    void SetUp() override
+    {
+        addTracker("3600_60", 3600, 60);
+        addTracker("86400_24", 86400, 24);
+        addTracker("604800_7", 604800, 7);
+        addTracker("2592000_30", 2592000, 30);
+        addTracker("31104000_12", 31104000, 12);
+    }
+
+    void addTracker(std::string trackerId, time_t duration_s, size_t sampleCount)
+    {
+        trackers.insert(std::make_pair(trackerId, Tracker(
+            trackerId,
+            duration_s,
+            sampleCount,
+            &mockClock,
+            std::make_unique<JsonTrackerStore>(std::make_unique<MockJsonResource>(), sampleCount),
+            std::make_unique<MockJsonResource>(),
+            std::make_unique<MockJsonResource>(),
+            AverageAccumulator(std::make_unique<MockJsonResource>())
+        )));
+    }
+
+    MockClock mockClock = MockClock();
+    TrackerMap trackers;
+};
+
+
+TEST_F(TrackerCascadeTest, buildsChainFromFineToCoarse)
+{
+    try
+    {
+        TrackerCascade::build(trackers);
+
+        EXPECT_FALSE(trackers.at("3600_60").isCascaded());
+        EXPECT_EQ(trackers.at("3600_60").getCascadeTargetIds(), std::vector<std::string>({"86400_24"}));
+
+        std::vector<std::string> dailyTargets = trackers.at("86400_24").getCascadeTargetIds();
+        std::sort(dailyTargets.begin(), dailyTargets.end());
+        EXPECT_EQ(dailyTargets, std::vector<std::string>({"2592000_30", "604800_7"}));
+
+        // Both daily trackers qualify as source, the ID decides
+        EXPECT_EQ(trackers.at("2592000_30").getCascadeTargetIds(), std::vector<std::string>({"31104000_12"}));
+        EXPECT_TRUE(trackers.at("604800_7").getCascadeTargetIds().empty());
+        EXPECT_TRUE(trackers.at("31104000_12").isCascaded());
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerCascadeTest, coarseTrackerMatchesFineTracker)
+{
+    try
+    {
+        TrackerCascade::build(trackers);
+
+        // A cascaded tracker starts with the first sample its source closes, so the daily trackers close
+        // their first day after one minute, one hour and one day
+        for (time_t second = 0; second < 3 * 86400; second++)
+        {
+            mockClock.tick();
+            TrackerCascade::track(trackers, (second / 60) % 10);
+        }
+
+        json minutes = trackers.at("3600_60").getData().at("data");
+        ASSERT_EQ(minutes.size(), 60u);
+        float hourAverage = 0.0f;
+        for (const auto& minute : minutes)
+            hourAverage += minute.get<float>() / minutes.size();
+
+        json hours = trackers.at("86400_24").getData().at("data");
+        ASSERT_EQ(hours.size(), 24u);
+        EXPECT_NEAR(hours.back().get<float>(), hourAverage, 0.01f);
+
+        json days = trackers.at("604800_7").getData().at("data");
+        ASSERT_EQ(days.size(), 2u);
+        EXPECT_NEAR(days.back().get<float>(), 4.5f, 0.01f);
+        EXPECT_EQ(days, trackers.at("2592000_30").getData().at("data"));
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerCascadeTest, rebuildsAfterTrackersChanged)
+{
+    try
+    {
+        TrackerCascade::build(trackers);
+        trackers.erase("86400_24");
+        TrackerCascade::build(trackers);
+
+        std::vector<std::string> hourlyTargets = trackers.at("3600_60").getCascadeTargetIds();
+        std::sort(hourlyTargets.begin(), hourlyTargets.end());
+        EXPECT_EQ(hourlyTargets, std::vector<std::string>({"2592000_30", "604800_7"}));
+        EXPECT_EQ(trackers.at("2592000_30").getCascadeTargetIds(), std::vector<std::string>({"31104000_12"}));
+        EXPECT_TRUE(trackers.at("604800_7").isCascaded());
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerCascadeTest, withoutCascadeEveryTrackerIsFedDirectly)
+{
+    try
+    {
+        for (time_t second = 0; second <= 3600; second++)
+        {
+            mockClock.tick();
+            TrackerCascade::track(trackers, 1.0f);
+        }
+
+        for (const auto& tracker : trackers)
+            EXPECT_FALSE(tracker.second.isCascaded());
+        EXPECT_EQ(trackers.at("86400_24").getData().at("data"), json({1.0}));
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
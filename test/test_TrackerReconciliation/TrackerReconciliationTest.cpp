@@ -0,0 +1,108 @@
+#include "TrackerReconciliation/TrackerReconciliation.h"
+#include "TrackerStore/JsonTrackerStore/JsonTrackerStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockClock.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+
+
+struct TrackerReconciliationTest : public testing::Test
+{
+    Tracker createTracker(const std::string& title, time_t duration_s, size_t sampleCount)
+    {
+        return Tracker(
+            title,
+            duration_s,
+            sampleCount,
+            &mockClock,
+            std::make_unique<JsonTrackerStore>(std::make_unique<MockJsonResource>(), sampleCount),
+            std::make_unique<MockJsonResource>(),
+            std::make_unique<MockJsonResource>(),
+            AverageAccumulator(std::make_unique<MockJsonResource>())
+        );
+    }
+
+    MockClock mockClock = MockClock();
+    json currentTrackersJson = {
+        {"3600_60", {{"title", "Last 60 Minutes"}, {"duration_s", 3600}, {"sampleCount", 60}}},
+        {"86400_24", {{"title", "Last 24 Hours"}, {"duration_s", 86400}, {"sampleCount", 24}}},
+        {"604800_7", {{"title", "Last 7 Days"}, {"duration_s", 604800}, {"sampleCount", 7}}},
+    };
+};
+
+
+TEST_F(TrackerReconciliationTest, plan)
+{
+    try
+    {
+        json trackersJson = currentTrackersJson;
+        trackersJson.erase("604800_7");
+        trackersJson["86400_24"]["title"] = "Today";
+        trackersJson["2592000_30"] = {{"title", "Last 30 Days"}, {"duration_s", 2592000}, {"sampleCount", 30}};
+
+        TrackerReconciliation::Plan plan = TrackerReconciliation::plan(currentTrackersJson, trackersJson);
+        EXPECT_EQ(plan.createdIds, std::vector<std::string>({"2592000_30"}));
+        EXPECT_EQ(plan.replacedIds, std::vector<std::string>({"86400_24"}));
+        EXPECT_EQ(plan.keptIds, std::vector<std::string>({"3600_60"}));
+        EXPECT_EQ(plan.removedIds, std::vector<std::string>({"604800_7"}));
+
+        // An unchanged config touches no tracker
+        plan = TrackerReconciliation::plan(currentTrackersJson, currentTrackersJson);
+        EXPECT_TRUE(plan.createdIds.empty());
+        EXPECT_TRUE(plan.replacedIds.empty());
+        EXPECT_EQ(plan.keptIds.size(), 3u);
+        EXPECT_TRUE(plan.removedIds.empty());
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerReconciliationTest, apply)
+{
+    try
+    {
+        TrackerMap trackers;
+        trackers.insert(std::make_pair("3600_60", createTracker("Last 60 Minutes", 3600, 60)));
+        trackers.insert(std::make_pair("86400_24", createTracker("Last 24 Hours", 86400, 24)));
+        trackers.insert(std::make_pair("604800_7", createTracker("Last 7 Days", 604800, 7)));
+        for (time_t second = 0; second <= 60; second++)
+        {
+            mockClock.tick();
+            trackers.at("3600_60").track(1.0f);
+        }
+
+        TrackerReconciliation::Plan plan;
+        plan.createdIds = {"2592000_30"};
+        plan.replacedIds = {"86400_24"};
+        plan.keptIds = {"3600_60"};
+        plan.removedIds = {"604800_7"};
+        TrackerMap preparedTrackers;
+        preparedTrackers.insert(std::make_pair("2592000_30", createTracker("Last 30 Days", 2592000, 30)));
+        preparedTrackers.insert(std::make_pair("86400_24", createTracker("Today", 86400, 24)));
+
+        TrackerMap removedTrackers = TrackerReconciliation::apply(trackers, plan, std::move(preparedTrackers));
+        ASSERT_EQ(removedTrackers.size(), 1u);
+        EXPECT_EQ(removedTrackers.count("604800_7"), 1u);
+        ASSERT_EQ(trackers.size(), 3u);
+        EXPECT_EQ(trackers.count("604800_7"), 0u);
+        EXPECT_EQ(trackers.at("86400_24").getData().at("title"), "Today");
+        EXPECT_EQ(trackers.at("2592000_30").getData().at("title"), "Last 30 Days");
+        // The kept tracker still holds the sample it closed
+        EXPECT_EQ(trackers.at("3600_60").getData().at("data").size(), 1u);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
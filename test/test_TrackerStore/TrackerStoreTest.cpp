@@ -0,0 +1,209 @@
+#include "TrackerStore/BinaryTrackerStore/BinaryTrackerStore.h"
+#include "TrackerStore/JsonTrackerStore/JsonTrackerStore.h"
+#include "TrackerStore/LazyTrackerStore/LazyTrackerStore.h"
+#include "ExceptionTrace/ExceptionTrace.h"
+#include "MockFile.h"
+#include "MockJsonResource.h"
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <math.h>
+
+
+constexpr size_t sampleCount = 60;
+
+
+struct TrackerStoreTest : public testing::Test
+{
+    MockFile* mockFile = new MockFile("/Trackers/test/data.bin", "data.bin");
+    BinaryTrackerStore uut = BinaryTrackerStore(std::unique_ptr<Filesystem::File>(mockFile), sampleCount);
+    JsonTrackerStore reference = JsonTrackerStore(std::make_unique<MockJsonResource>(), sampleCount);
+};
+
+
+TEST_F(TrackerStoreTest, emptyStoreHasNoData)
+{
+    EXPECT_EQ(uut.getData(), json());
+    EXPECT_FALSE(uut.getEpoch().has_value());
+}
+
+
+TEST_F(TrackerStoreTest, behavesLikeJsonTrackerStore)
+{
+    try
+    {
+        for (size_t i = 0; i < 150; i++)
+        {
+            std::vector<float> values;
+            if (i % 17 == 0)
+                values.push_back(NAN);
+            values.push_back(i * 0.5f);
+            uut.append(values, i);
+            reference.append(values, i);
+            ASSERT_EQ(uut.getData(), reference.getData());
+        }
+        EXPECT_EQ(uut.getEpoch().value(), 149);
+
+        // More values than fit at once, e.g. after a long power off period
+        std::vector<float> values(sampleCount + 5, NAN);
+        values.back() = 42.0f;
+        uut.append(values, 1000);
+        reference.append(values, 1000);
+        EXPECT_EQ(uut.getData(), reference.getData());
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerStoreTest, appendWritesOnlyRecordAndHeader)
+{
+    try
+    {
+        uut.append({1.0f}, 1);
+        size_t fileSize = mockFile->stream.str().size();
+        std::string before = mockFile->stream.str();
+        uut.append({2.0f}, 2);
+        std::string after = mockFile->stream.str();
+
+        ASSERT_EQ(after.size(), fileSize);
+        size_t changedBytes = 0;
+        for (size_t i = 0; i < fileSize; i++)
+            changedBytes += before[i] != after[i];
+        // One 4 byte record plus one 36 byte header copy at most
+        EXPECT_LE(changedBytes, 40u);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerStoreTest, survivesReopeningAndCorruptedHeader)
+{
+    try
+    {
+        for (size_t i = 0; i < 70; i++)
+            uut.append({static_cast<float>(i)}, i);
+        json expectedData = uut.getData();
+
+        MockFile* reopenedFile = new MockFile(mockFile->path, mockFile->name);
+        reopenedFile->stream.str(mockFile->stream.str());
+        BinaryTrackerStore reopened(std::unique_ptr<Filesystem::File>(reopenedFile), sampleCount);
+        EXPECT_EQ(reopened.getData(), expectedData);
+
+        // Break the header copy written last (sequence 69 lives in the second copy),
+        // the store has to fall back to the state before the last append
+        std::string content = mockFile->stream.str();
+        content[36 + 10] ^= 0xFF;
+        MockFile* corruptedFile = new MockFile(mockFile->path, mockFile->name);
+        corruptedFile->stream.str(content);
+        BinaryTrackerStore corrupted(std::unique_ptr<Filesystem::File>(corruptedFile), sampleCount);
+        json data = corrupted.getData();
+        ASSERT_EQ(data.size(), sampleCount);
+        EXPECT_EQ(data.front(), 9);
+        EXPECT_EQ(data.back(), 68);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerStoreTest, keepsNewestValuesWhenSampleCountChanges)
+{
+    try
+    {
+        for (size_t i = 0; i < 30; i++)
+            uut.append({static_cast<float>(i)}, i);
+
+        MockFile* reopenedFile = new MockFile(mockFile->path, mockFile->name);
+        reopenedFile->stream.str(mockFile->stream.str());
+        BinaryTrackerStore reopened(std::unique_ptr<Filesystem::File>(reopenedFile), 10);
+        json expectedData = {20, 21, 22, 23, 24, 25, 26, 27, 28, 29};
+        EXPECT_EQ(reopened.getData(), expectedData);
+        EXPECT_EQ(reopened.getEpoch().value(), 29);
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerStoreTest, setData)
+{
+    try
+    {
+        json data = {1.5, nullptr, 3};
+        uut.setData(data);
+        EXPECT_EQ(uut.getData(), data);
+        EXPECT_ANY_THROW(uut.setData("no array"));
+        ExceptionTrace::clear();
+    }
+    catch(...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+TEST_F(TrackerStoreTest, benchmarkAppend)
+{
+    constexpr size_t largeSampleCount = 4096;
+    constexpr size_t appendCount = 500;
+    BinaryTrackerStore binaryStore(std::unique_ptr<Filesystem::File>(new MockFile("data.bin", "data.bin")), largeSampleCount);
+    JsonTrackerStore jsonStore(std::make_unique<MockJsonResource>(), largeSampleCount);
+    binaryStore.setData(std::vector<float>(largeSampleCount, 1.0f));
+    jsonStore.setData(std::vector<float>(largeSampleCount, 1.0f));
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < appendCount; i++)
+        binaryStore.append({static_cast<float>(i)}, i);
+    auto binaryDuration = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < appendCount; i++)
+        jsonStore.append({static_cast<float>(i)}, i);
+    auto jsonDuration = std::chrono::steady_clock::now() - start;
+
+    std::cout << "Append to " << largeSampleCount << " samples: binary "
+        << std::chrono::duration_cast<std::chrono::microseconds>(binaryDuration).count() / appendCount << " us, json "
+        << std::chrono::duration_cast<std::chrono::microseconds>(jsonDuration).count() / appendCount << " us" << std::endl;
+    EXPECT_LT(binaryDuration, jsonDuration);
+}
+
+
+TEST(LazyTrackerStoreTest, opensOnFirstAccess)
+{
+    try
+    {
+        size_t openCount = 0;
+        LazyTrackerStore uut([&openCount]{
+            openCount++;
+            return std::unique_ptr<TrackerStore>(new JsonTrackerStore(std::make_unique<MockJsonResource>(), sampleCount));
+        });
+        EXPECT_FALSE(uut.isOpen());
+        EXPECT_EQ(openCount, 0);
+
+        uut.append({1.0f, 2.0f}, 0);
+        EXPECT_TRUE(uut.isOpen());
+        EXPECT_EQ(uut.getData(), json({1.0f, 2.0f}));
+        EXPECT_EQ(openCount, 1);
+    }
+    catch (...)
+    {
+        FAIL() << ExceptionTrace::what() << std::endl;
+    }
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}
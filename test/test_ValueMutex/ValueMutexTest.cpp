@@ -0,0 +1,51 @@
+#include "Rtos/ValueMutex/ValueMutex.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+
+
+TEST(ValueMutexTest, countsUncontendedLocks)
+{
+    Rtos::ValueMutex<int> uut(1);
+    for (size_t i = 0; i < 10; i++)
+        (*uut.get())++;
+
+    Rtos::LockWaitStatistics statistics = uut.getWaitStatistics();
+    EXPECT_EQ(*uut.get(), 11);
+    EXPECT_EQ(statistics.lockCount, 10u);
+    EXPECT_EQ(statistics.contendedCount, 0u);
+    EXPECT_EQ(statistics.totalWait_us, 0u);
+}
+
+
+TEST(ValueMutexTest, measuresWaitTimeOfContendedLocks)
+{
+    Rtos::ValueMutex<int> uut(0);
+    std::atomic<bool> isLocked(false);
+    std::thread holder([&]{
+        Rtos::ValueMutex<int>::Lock lock = uut.get();
+        isLocked = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    });
+    while (!isLocked)
+        std::this_thread::yield();
+
+    uut.get();
+    holder.join();
+
+    // Statistics can be polled while the value is locked
+    Rtos::ValueMutex<int>::Lock lock = uut.get();
+    Rtos::LockWaitStatistics statistics = uut.getWaitStatistics();
+    EXPECT_EQ(statistics.lockCount, 3u);
+    EXPECT_EQ(statistics.contendedCount, 1u);
+    EXPECT_GE(statistics.maxWait_us, 20000u);
+    EXPECT_EQ(statistics.totalWait_us, statistics.maxWait_us);
+}
+
+
+int main()
+{
+    testing::InitGoogleTest();
+    return RUN_ALL_TESTS();
+}